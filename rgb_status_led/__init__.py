@@ -11,20 +11,62 @@ Author: Bluscream
 License: MIT
 """
 
+from esphome import automation
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import light, output
-from esphome.const import CONF_ID, CONF_OUTPUT, CONF_RED, CONF_GREEN, CONF_BLUE
-from esphome.core import CoroPriority, coroutine_with_priority
+from esphome.components import light, output, sensor
+from esphome.const import (
+    CONF_ID, CONF_NAME, CONF_OUTPUT, CONF_PLATFORM, CONF_RED, CONF_GREEN, CONF_BLUE,
+    STATE_CLASS_MEASUREMENT, UNIT_MICROSECOND,
+)
+from esphome.core import CORE, CoroPriority, TimePeriod, coroutine_with_priority
 
 # Component metadata
 CODEOWNERS = ["@esphome/core"]
-AUTO_LOAD = ["light"]
+
+
+def AUTO_LOAD():
+    """Load the sensor component only when some instance reports latency through a sensor."""
+    lights = CORE.raw_config.get("light") or []
+    if not isinstance(lights, list):
+        lights = [lights]
+    if any(
+        isinstance(conf, dict) and conf.get(CONF_PLATFORM) == "rgb_status_led" and CONF_LATENCY_SENSOR in conf
+        for conf in lights
+    ):
+        return ["light", "sensor"]
+    return ["light"]
+
 
 # Namespace for the component
 rgb_status_led_ns = cg.esphome_ns.namespace("rgb_status_led")
-RGBStatusLED = rgb_status_led_ns.class_("RGBStatusLED", light::LightOutput, cg.Component)
-EventConfig = rgb_status_led_ns.struct("EventConfig")
+RGBStatusLED = rgb_status_led_ns.class_("RGBStatusLED", light.LightOutput, cg.Component)
+StatusSource = rgb_status_led_ns.class_("StatusSource")
+SourceRaiseAction = rgb_status_led_ns.class_("SourceRaiseAction", automation.Action)
+SourceClearAction = rgb_status_led_ns.class_("SourceClearAction", automation.Action)
+StatusState = rgb_status_led_ns.enum("StatusState", is_class=True)
+EffectType = rgb_status_led_ns.enum("EffectType", is_class=True)
+PackedEventConfig = rgb_status_led_ns.struct("PackedEventConfig")
+Keyframe = rgb_status_led_ns.struct("Keyframe")
+Timeline = rgb_status_led_ns.struct("Timeline")
+Pattern = rgb_status_led_ns.struct("Pattern")
+STATUS_STATE_COUNT = rgb_status_led_ns.STATUS_STATE_COUNT
+
+# Effect names resolved to C++ enum values at code generation time
+EFFECTS = {
+    "none": EffectType.NONE,
+    "blink": EffectType.BLINK,
+    "pulse": EffectType.PULSE,
+    "timeline": EffectType.TIMELINE,
+    "pattern": EffectType.PATTERN,
+    "code": EffectType.CODE,
+}
+
+# Keyframe interpolation modes, must match the Keyframe constants
+INTERPOLATIONS = {
+    "step": 0,
+    "linear": 1,
+}
 
 # Configuration keys for different events
 CONF_ERROR = "error"
@@ -39,11 +81,59 @@ CONF_OTA_PROGRESS = "ota_progress"
 CONF_OTA_END = "ota_end"
 CONF_OTA_ERROR = "ota_error"
 
+# Event keys mapped to their StatusState bit (must match the StatusState enum)
+EVENT_STATES = {
+    CONF_OK: 1,
+    CONF_WIFI_CONNECTED: 3,
+    CONF_API_DISCONNECTED: 4,
+    CONF_API_CONNECTED: 5,
+    CONF_BOOT: 6,
+    CONF_WARNING: 7,
+    CONF_ERROR: 8,
+    CONF_OTA_END: 9,
+    CONF_OTA_PROGRESS: 10,
+    CONF_OTA_BEGIN: 11,
+    CONF_OTA_ERROR: 12,
+}
+
 # Event configuration keys
 CONF_ENABLED = "enabled"
 CONF_COLOR = "color"
 CONF_BRIGHTNESS = "brightness"
 CONF_EFFECT = "effect"
+CONF_PERIOD = "period"
+CONF_DUTY = "duty"
+CONF_PHASE_OFFSET = "phase_offset"
+CONF_KEYFRAMES = "keyframes"
+CONF_DURATION = "duration"
+CONF_LEVEL = "level"
+CONF_INTERPOLATION = "interpolation"
+CONF_PATTERN = "pattern"
+CONF_CODE = "code"
+CONF_WAIT = "wait"
+CONF_REPEAT = "repeat"
+CONF_COUNT = "count"
+CONF_WHILE = "while"
+CONF_IF = "if"
+CONF_CONDITION = "condition"
+CONF_THEN = "then"
+CONF_ELSE = "else"
+
+# Status source keys
+CONF_SOURCES = "sources"
+CONF_ABOVE = "above"
+CONF_PRIORITY = "priority"
+MAX_STATUS_SOURCES = 32
+
+# Pattern bytecode, must match PatternOp and PATTERN_MAX_DEPTH in pattern.h
+PATTERN_OP_COLOR = 1
+PATTERN_OP_WAIT = 2
+PATTERN_OP_REPEAT = 3
+PATTERN_OP_END_REPEAT = 4
+PATTERN_OP_JUMP = 5
+PATTERN_OP_JUMP_IF_INACTIVE = 6
+PATTERN_MAX_DEPTH = 4
+PATTERN_MAX_SIZE = 65535
 
 # Global configuration keys
 CONF_ERROR_BLINK_SPEED = "error_blink_speed"
@@ -51,6 +141,40 @@ CONF_WARNING_BLINK_SPEED = "warning_blink_speed"
 CONF_BRIGHTNESS = "brightness"
 CONF_PRIORITY_MODE = "priority_mode"
 CONF_OK_STATE_ENABLED = "ok_state_enabled"
+CONF_EVENT_DRIVEN = "event_driven"
+CONF_APP_STATE_POLL_INTERVAL = "app_state_poll_interval"
+CONF_LOOP_STATS = "loop_stats"
+CONF_LOOP_BUDGET = "loop_budget"
+CONF_LATENCY_STATS = "latency_stats"
+CONF_LATENCY_SENSOR = "latency_sensor"
+CONF_OUTPUT_CORRECTION = "output_correction"
+CONF_OUTPUT_GAMMA = "output_gamma"
+CONF_DITHER_BITS = "dither_bits"
+CONF_TRANSITION_LENGTH = "transition_length"
+CONF_TRANSITION_MAX_FPS = "transition_max_fps"
+
+# Output correction table size, must match CORRECTION_TABLE_STEPS in render.h
+CORRECTION_TABLE_STEPS = 256
+
+# Effect cycles, must match PULSE_PERIOD, CODE_PAUSE_SLOTS and CODE_MAX in render.h
+PULSE_PERIOD = 2000
+CODE_PAUSE_SLOTS = 4
+CODE_MAX = 14
+
+# Timing options and the effects that use them
+TIMING_EFFECTS = {
+    CONF_PERIOD: ("blink", "code"),
+    CONF_DUTY: ("blink",),
+    CONF_PHASE_OFFSET: ("blink", "pulse", "code"),
+}
+
+
+def cie_lstar(x):
+    """CIE 1931 lightness L* (0-1) to relative luminance (0-1)."""
+    lightness = x * 100.0
+    if lightness <= 8.0:
+        return lightness / 903.3
+    return ((lightness + 16.0) / 116.0) ** 3
 
 # Schema for RGB color configuration
 ColorSchema = cv.Schema({
@@ -59,13 +183,211 @@ ColorSchema = cv.Schema({
     cv.Required(CONF_BLUE): cv.percentage,
 })
 
+# Schema for one keyframe of a timeline effect; `level` scales the event color, `color` replaces it
+KeyframeSchema = cv.All(cv.Schema({
+    cv.Required(CONF_DURATION): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=TimePeriod(milliseconds=1), max=TimePeriod(milliseconds=65535)),
+    ),
+    cv.Optional(CONF_COLOR): ColorSchema,
+    cv.Optional(CONF_LEVEL): cv.percentage,
+    cv.Optional(CONF_INTERPOLATION, default="linear"): cv.enum(INTERPOLATIONS, lower=True),
+}), cv.has_exactly_one_key(CONF_COLOR, CONF_LEVEL))
+
+
+def pattern_block(depth):
+    """Validator for a list of pattern steps nested `depth` repeat loops deep."""
+    def validator(value):
+        if not isinstance(value, list):
+            value = [value]
+        return [pattern_step(step, depth) for step in value]
+    return validator
+
+
+def pattern_step(value, depth):
+    """Validate one pattern step: color, level, wait, repeat, while or if."""
+    if not isinstance(value, dict) or len(value) != 1:
+        raise cv.Invalid("Each pattern step needs exactly one of color, level, wait, repeat, while or if")
+    key, arg = next(iter(value.items()))
+    if key == CONF_COLOR:
+        return {key: ColorSchema(arg)}
+    if key == CONF_LEVEL:
+        return {key: cv.percentage(arg)}
+    if key == CONF_WAIT:
+        return {key: cv.All(
+            cv.positive_time_period_milliseconds, cv.Range(max=TimePeriod(milliseconds=65535))
+        )(arg)}
+    if key == CONF_REPEAT:
+        if depth >= PATTERN_MAX_DEPTH:
+            raise cv.Invalid(f"repeat can be nested at most {PATTERN_MAX_DEPTH} levels deep")
+        return {key: cv.All(cv.Schema({
+            cv.Required(CONF_COUNT): cv.int_range(min=1, max=255),
+            cv.Required(CONF_THEN): pattern_block(depth + 1),
+        }), validate_loop_waits)(arg)}
+    if key in (CONF_WHILE, CONF_IF):
+        schema = {
+            cv.Required(CONF_CONDITION): cv.one_of(*EVENT_STATES, lower=True),
+            cv.Required(CONF_THEN): pattern_block(depth),
+        }
+        if key == CONF_IF:
+            schema[cv.Optional(CONF_ELSE, default=[])] = pattern_block(depth)
+            return {key: cv.Schema(schema)(arg)}
+        return {key: cv.All(cv.Schema(schema), validate_loop_waits)(arg)}
+    raise cv.Invalid(f"Unknown pattern step '{key}'")
+
+
+def pattern_waits(steps):
+    """Whether every path through the steps waits a non-zero time."""
+    for step in steps:
+        key, arg = next(iter(step.items()))
+        if key == CONF_WAIT and arg.total_milliseconds > 0:
+            return True
+        if key == CONF_REPEAT and pattern_waits(arg[CONF_THEN]):
+            return True
+        if key == CONF_IF and pattern_waits(arg[CONF_THEN]) and pattern_waits(arg[CONF_ELSE]):
+            return True
+    return False
+
+
+def validate_loop_waits(config):
+    """A loop body that never waits would spend the whole per-tick instruction budget on every tick."""
+    if not pattern_waits(config[CONF_THEN]):
+        raise cv.Invalid("the loop body must wait a non-zero time on every path", path=[CONF_THEN])
+    return config
+
+
+def validate_pattern_waits(steps):
+    """The program restarts after its last step, so it has to wait somewhere on every path."""
+    if not pattern_waits(steps):
+        raise cv.Invalid("the pattern must wait a non-zero time on every path")
+    return steps
+
+
+def compile_pattern(steps, event_color, code=None):
+    """Compile validated pattern steps to PatternVM bytecode (see pattern.h)."""
+    if code is None:
+        code = []
+    
+    def address(addr):
+        return [addr & 0xFF, addr >> 8]
+    
+    for step in steps:
+        key, arg = next(iter(step.items()))
+        if key in (CONF_COLOR, CONF_LEVEL):
+            if key == CONF_COLOR:
+                rgb = [arg[CONF_RED], arg[CONF_GREEN], arg[CONF_BLUE]]
+            else:
+                rgb = [event_color[c] * arg for c in (CONF_RED, CONF_GREEN, CONF_BLUE)]
+            code += [PATTERN_OP_COLOR] + [round(min(max(v, 0.0), 1.0) * 255) for v in rgb]
+        elif key == CONF_WAIT:
+            code += [PATTERN_OP_WAIT] + address(arg.total_milliseconds)
+        elif key == CONF_REPEAT:
+            code += [PATTERN_OP_REPEAT, arg[CONF_COUNT]]
+            body = len(code)
+            compile_pattern(arg[CONF_THEN], event_color, code)
+            code += [PATTERN_OP_END_REPEAT] + address(body)
+        elif key == CONF_WHILE:
+            top = len(code)
+            code += [PATTERN_OP_JUMP_IF_INACTIVE, EVENT_STATES[arg[CONF_CONDITION]], 0, 0]
+            compile_pattern(arg[CONF_THEN], event_color, code)
+            code += [PATTERN_OP_JUMP] + address(top)
+            code[top + 2:top + 4] = address(len(code))
+        else:  # if
+            branch = len(code)
+            code += [PATTERN_OP_JUMP_IF_INACTIVE, EVENT_STATES[arg[CONF_CONDITION]], 0, 0]
+            compile_pattern(arg[CONF_THEN], event_color, code)
+            if arg[CONF_ELSE]:
+                skip = len(code)
+                code += [PATTERN_OP_JUMP, 0, 0]
+                code[branch + 2:branch + 4] = address(len(code))
+                compile_pattern(arg[CONF_ELSE], event_color, code)
+                code[skip + 1:skip + 3] = address(len(code))
+            else:
+                code[branch + 2:branch + 4] = address(len(code))
+    if len(code) > PATTERN_MAX_SIZE:
+        raise cv.Invalid(f"pattern compiles to {len(code)} bytes, at most {PATTERN_MAX_SIZE} are supported")
+    return code
+
+
+def effect_cycle(effect, period, code):
+    """Length in milliseconds of one cycle of a phase-driven effect, None for the others."""
+    if effect == "blink":
+        return period
+    if effect == "pulse":
+        return PULSE_PERIOD
+    if effect == "code":
+        slot = period // 2 if period >= 2 else 1
+        return slot * (2 * min(code, CODE_MAX) + CODE_PAUSE_SLOTS)
+    return None
+
+
+def validate_timing(config):
+    """Timing options are only accepted by the effects that use them."""
+    effect = str(config[CONF_EFFECT])
+    for key, effects in TIMING_EFFECTS.items():
+        if key in config and effect not in effects:
+            raise cv.Invalid(
+                f"{key} only applies to the {', '.join(effects)} effect{'s' if len(effects) > 1 else ''}, "
+                f"not '{effect}'",
+                path=[key],
+            )
+    return config
+
+
+def validate_timeline(config):
+    """The timeline and pattern effects need their program, and programs need their effect."""
+    if (str(config[CONF_EFFECT]) == "timeline") != (CONF_KEYFRAMES in config):
+        raise cv.Invalid("keyframes must be given exactly when effect is 'timeline'")
+    if (str(config[CONF_EFFECT]) == "pattern") != (CONF_PATTERN in config):
+        raise cv.Invalid("pattern must be given exactly when effect is 'pattern'")
+    return config
+
+
 # Schema for individual event configuration
-EventConfigSchema = cv.Schema({
+EventConfigSchema = cv.All(cv.Schema({
     cv.Optional(CONF_ENABLED, default=True): cv.boolean,
     cv.Optional(CONF_COLOR, default={CONF_RED: 1.0, CONF_GREEN: 1.0, CONF_BLUE: 1.0}): ColorSchema,
     cv.Optional(CONF_BRIGHTNESS, default=1.0): cv.percentage,
-    cv.Optional(CONF_EFFECT, default="none"): cv.string,
-})
+    cv.Optional(CONF_EFFECT, default="none"): cv.enum(EFFECTS, lower=True),
+    # Blink timing, stored as 16-bit milliseconds; period and duty default per event
+    cv.Optional(CONF_PERIOD): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=TimePeriod(milliseconds=1), max=TimePeriod(milliseconds=65535)),
+    ),
+    cv.Optional(CONF_DUTY): cv.percentage,
+    # Shift into the cycle of the blink, pulse or code effect
+    cv.Optional(CONF_PHASE_OFFSET): cv.All(
+        cv.positive_time_period_milliseconds, cv.Range(max=TimePeriod(milliseconds=65535))
+    ),
+    # Keyframes played in a loop by the timeline effect
+    cv.Optional(CONF_KEYFRAMES): cv.All(cv.ensure_list(KeyframeSchema), cv.Length(min=1, max=255)),
+    # Number of blinks shown by the code effect, can be changed at runtime with set_blink_code()
+    cv.Optional(CONF_CODE, default=1): cv.int_range(min=0, max=14),
+    # Program run by the pattern effect
+    cv.Optional(CONF_PATTERN): cv.All(pattern_block(0), cv.Length(min=1), validate_pattern_waits),
+}), validate_timeline, validate_timing)
+
+# Schema for a named status source, raised and cleared through its id; timelines and patterns are per event only
+StatusSourceSchema = cv.All(cv.Schema({
+    cv.Required(CONF_ID): cv.declare_id(StatusSource),
+    cv.Optional(CONF_NAME): cv.string,
+    # Built-in state the source ranks directly above, and its order among sources on the same state
+    cv.Optional(CONF_ABOVE, default=CONF_API_CONNECTED): cv.one_of(*EVENT_STATES, lower=True),
+    cv.Optional(CONF_PRIORITY, default=0): cv.uint8_t,
+    cv.Optional(CONF_COLOR, default={CONF_RED: 1.0, CONF_GREEN: 1.0, CONF_BLUE: 1.0}): ColorSchema,
+    cv.Optional(CONF_BRIGHTNESS, default=1.0): cv.percentage,
+    cv.Optional(CONF_EFFECT, default="none"): cv.one_of("none", "blink", "pulse", "code", lower=True),
+    # Blink and code timing; period defaults to 1000ms and duty to 50%
+    cv.Optional(CONF_PERIOD): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=TimePeriod(milliseconds=1), max=TimePeriod(milliseconds=65535)),
+    ),
+    cv.Optional(CONF_DUTY): cv.percentage,
+    cv.Optional(CONF_PHASE_OFFSET): cv.All(
+        cv.positive_time_period_milliseconds, cv.Range(max=TimePeriod(milliseconds=65535))
+    ),
+    cv.Optional(CONF_CODE, default=1): cv.int_range(min=0, max=14),
+}), validate_timing)
 
 # Main configuration schema for the RGB Status LED component
 CONFIG_SCHEMA = light.RGB_LIGHT_SCHEMA.extend(
@@ -157,8 +479,15 @@ CONFIG_SCHEMA = light.RGB_LIGHT_SCHEMA.extend(
         }): EventConfigSchema,
         
         # Global timing configurations
-        cv.Optional(CONF_ERROR_BLINK_SPEED, default="250ms"): cv.positive_time_period,
-        cv.Optional(CONF_WARNING_BLINK_SPEED, default="1500ms"): cv.positive_time_period,
+        # Blink periods are stored as 16-bit milliseconds
+        cv.Optional(CONF_ERROR_BLINK_SPEED, default="250ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=TimePeriod(milliseconds=1), max=TimePeriod(milliseconds=65535)),
+        ),
+        cv.Optional(CONF_WARNING_BLINK_SPEED, default="1500ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=TimePeriod(milliseconds=1), max=TimePeriod(milliseconds=65535)),
+        ),
         cv.Optional(CONF_BRIGHTNESS, default=0.5): cv.percentage,
         
         # Priority mode: "status" (default) or "user"
@@ -166,10 +495,136 @@ CONFIG_SCHEMA = light.RGB_LIGHT_SCHEMA.extend(
         
         # OK state configuration
         cv.Optional(CONF_OK_STATE_ENABLED, default=True): cv.boolean,
+        
+        # Event-driven scheduling: only run loop() when the output can change
+        cv.Optional(CONF_EVENT_DRIVEN, default=False): cv.boolean,
+        cv.Optional(CONF_APP_STATE_POLL_INTERVAL, default="100ms"): cv.positive_time_period_milliseconds,
+        
+        # Per-state loop cost statistics, logged every minute
+        cv.Optional(CONF_LOOP_STATS, default=False): cv.boolean,
+        cv.Optional(CONF_LOOP_BUDGET): cv.positive_time_period_microseconds,
+        
+        # Event to light latency histogram, p50/p99 in dump_config and optionally as a sensor
+        cv.Optional(CONF_LATENCY_STATS, default=False): cv.boolean,
+        cv.Optional(CONF_LATENCY_SENSOR): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MICROSECOND,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        
+        # Perceptual output correction, applied from a table generated at build time
+        cv.Optional(CONF_OUTPUT_CORRECTION, default="none"): cv.one_of("none", "gamma", "cie", lower=True),
+        cv.Optional(CONF_OUTPUT_GAMMA, default=2.2): cv.float_range(min=1.0, max=4.0),
+        
+        # Temporal dithering down to the PWM resolution of the outputs
+        cv.Optional(CONF_DITHER_BITS): cv.int_range(min=8, max=15),
+        
+        # Crossfade between status states
+        cv.Optional(CONF_TRANSITION_LENGTH, default="0ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_TRANSITION_MAX_FPS, default=50): cv.int_range(min=1, max=1000),
+        
+        # Additional named status sources, e.g. battery low or MQTT disconnected
+        cv.Optional(CONF_SOURCES, default=[]): cv.All(
+            cv.ensure_list(StatusSourceSchema), cv.Length(max=MAX_STATUS_SOURCES)
+        ),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
 
+def generate_timelines(config):
+    """Emit each enabled event's keyframes as constant arrays plus a Timeline table indexed by StatusState."""
+    prefix = config[CONF_ID].id
+    timelines = ["{nullptr, 0, 0}"] * (max(EVENT_STATES.values()) + 1)
+    for key, bit in EVENT_STATES.items():
+        event_config = config[key]
+        if not event_config[CONF_ENABLED] or CONF_KEYFRAMES not in event_config:
+            continue
+        rows = []
+        total = 0
+        for keyframe in event_config[CONF_KEYFRAMES]:
+            if CONF_COLOR in keyframe:
+                color = keyframe[CONF_COLOR]
+                rgb = [color[CONF_RED], color[CONF_GREEN], color[CONF_BLUE]]
+            else:
+                color = event_config[CONF_COLOR]
+                rgb = [color[c] * keyframe[CONF_LEVEL] for c in (CONF_RED, CONF_GREEN, CONF_BLUE)]
+            duration = keyframe[CONF_DURATION].total_milliseconds
+            total += duration
+            channels = ", ".join(str(round(min(max(v, 0.0), 1.0) * 255)) for v in rgb)
+            rows.append(f"{{{duration}, {channels}, {keyframe[CONF_INTERPOLATION].enum_value}}}")
+        array = f"{prefix}_{key}_keyframes"
+        cg.add_global(cg.RawStatement(
+            f"static constexpr {Keyframe} {array}[{len(rows)}] = {{" + ", ".join(rows) + "};"
+        ))
+        timelines[bit] = f"{{{array}, {len(rows)}, {total}}}"
+    
+    table = f"{prefix}_timeline_table"
+    cg.add_global(cg.RawStatement(
+        f"static constexpr {Timeline} {table}[{STATUS_STATE_COUNT}] = {{\n"
+        + "".join(f"    {timeline},\n" for timeline in timelines)
+        + "};"
+    ))
+    return table
+
+
+def generate_patterns(config):
+    """Emit each enabled event's compiled pattern as a constant array plus a Pattern table indexed by StatusState."""
+    prefix = config[CONF_ID].id
+    patterns = ["{nullptr, 0}"] * (max(EVENT_STATES.values()) + 1)
+    for key, bit in EVENT_STATES.items():
+        event_config = config[key]
+        if not event_config[CONF_ENABLED] or CONF_PATTERN not in event_config:
+            continue
+        code = compile_pattern(event_config[CONF_PATTERN], event_config[CONF_COLOR])
+        array = f"{prefix}_{key}_pattern"
+        cg.add_global(cg.RawStatement(
+            f"static constexpr uint8_t {array}[{len(code)}] = {{" + ", ".join(str(b) for b in code) + "};"
+        ))
+        patterns[bit] = f"{{{array}, {len(code)}}}"
+    
+    table = f"{prefix}_pattern_table"
+    cg.add_global(cg.RawStatement(
+        f"static constexpr {Pattern} {table}[{STATUS_STATE_COUNT}] = {{\n"
+        + "".join(f"    {pattern},\n" for pattern in patterns)
+        + "};"
+    ))
+    return table
+
+
+def compiled_features(config):
+    """Enabled event bits and effect names one instance needs compiled in."""
+    enabled_events = 1  # NONE is always available
+    effects = set()
+    for key, bit in EVENT_STATES.items():
+        event_config = config[key]
+        if event_config[CONF_ENABLED]:
+            enabled_events |= 1 << bit
+            effects.add(str(event_config[CONF_EFFECT]))
+    for source in config[CONF_SOURCES]:
+        effects.add(str(source[CONF_EFFECT]))
+    return enabled_events, effects
+
+
+def build_features(config):
+    """
+    Union of compiled_features() over every rgb_status_led light in the build.
+    
+    The feature defines are build-wide, so each instance emits the same union (identical
+    defines are merged) and its own table decides what it actually shows.
+    """
+    instances = [
+        conf for conf in CORE.config.get("light", [])
+        if isinstance(conf, dict) and conf.get(CONF_PLATFORM) == "rgb_status_led"
+    ] or [config]
+    enabled_events = 1
+    effects = set()
+    for conf in instances:
+        instance_events, instance_effects = compiled_features(conf)
+        enabled_events |= instance_events
+        effects |= instance_effects
+    return enabled_events, effects
+
+
 @coroutine_with_priority(CoroPriority.STATUS)
 async def to_code(config):
     """
@@ -194,41 +649,145 @@ async def to_code(config):
     cg.add(var.set_green_output(green))
     cg.add(var.set_blue_output(blue))
     
-    # Helper function to create EventConfig
-    def create_event_config(event_config):
+    def c_float(value):
+        return f"{float(value)!r}f"
+    
+    def packed_config(event_config, enabled, effect, period, duty):
+        """PackedEventConfig initializer for an event or source configuration."""
         color = event_config[CONF_COLOR]
-        return cg.StructInitializer(
-            EventConfig,
-            ("enabled", event_config[CONF_ENABLED]),
-            ("color", cg.StructInitializer(
-                rgb_status_led_ns.struct("RGBColor"),
-                ("r", color[CONF_RED]),
-                ("g", color[CONF_GREEN]),
-                ("b", color[CONF_BLUE])
-            )),
-            ("brightness", event_config[CONF_BRIGHTNESS]),
-            ("effect", event_config[CONF_EFFECT])
+        period = period.total_milliseconds
+        on_time = round(period * duty)
+        # Wrap the offset by the cycle of the effect that uses it; the others have no phase
+        phase = event_config.get(CONF_PHASE_OFFSET, TimePeriod(milliseconds=0)).total_milliseconds
+        cycle = effect_cycle(str(event_config[CONF_EFFECT]), period, event_config[CONF_CODE])
+        if cycle is not None:
+            phase %= cycle
+        return (
+            f"{{{{{'true' if enabled else 'false'}, "
+            f"{{{c_float(color[CONF_RED])}, {c_float(color[CONF_GREEN])}, {c_float(color[CONF_BLUE])}}}, "
+            f"{c_float(event_config[CONF_BRIGHTNESS])}, {effect}}}, "
+            f"{period}, {on_time}, {phase}, {event_config[CONF_CODE]}}}"
+        )
+    
+    # Default blink timing per state as (period, duty), matching ESPHome's status_led duty cycles
+    default_timings = {
+        CONF_ERROR: (config[CONF_ERROR_BLINK_SPEED], 0.6),
+        CONF_WARNING: (config[CONF_WARNING_BLINK_SPEED], 1 / 6),
+    }
+    
+    # Build the event table indexed by StatusState; NONE and USER are never rendered from it
+    rows = [f"{{{{false, {{0.0f, 0.0f, 0.0f}}, 1.0f, {EffectType.NONE}}}, 1000, 500}}"] * (max(EVENT_STATES.values()) + 1)
+    for key, bit in EVENT_STATES.items():
+        event_config = config[key]
+        default_period, default_duty = default_timings.get(key, (TimePeriod(milliseconds=1000), 0.5))
+        enabled = event_config[CONF_ENABLED]
+        rows[bit] = packed_config(
+            event_config, enabled, event_config[CONF_EFFECT].enum_value,
+            event_config.get(CONF_PERIOD, default_period), event_config.get(CONF_DUTY, default_duty),
         )
     
-    # Configure event states
-    cg.add(var.set_error_config(create_event_config(config[CONF_ERROR])))
-    cg.add(var.set_warning_config(create_event_config(config[CONF_WARNING])))
-    cg.add(var.set_ok_config(create_event_config(config[CONF_OK])))
-    cg.add(var.set_boot_config(create_event_config(config[CONF_BOOT])))
-    cg.add(var.set_wifi_connected_config(create_event_config(config[CONF_WIFI_CONNECTED])))
-    cg.add(var.set_api_connected_config(create_event_config(config[CONF_API_CONNECTED])))
-    cg.add(var.set_api_disconnected_config(create_event_config(config[CONF_API_DISCONNECTED])))
-    cg.add(var.set_ota_begin_config(create_event_config(config[CONF_OTA_BEGIN])))
-    cg.add(var.set_ota_progress_config(create_event_config(config[CONF_OTA_PROGRESS])))
-    cg.add(var.set_ota_end_config(create_event_config(config[CONF_OTA_END])))
-    cg.add(var.set_ota_error_config(create_event_config(config[CONF_OTA_ERROR])))
+    # Constant table in flash, the component only keeps a pointer to it
+    table = f"{config[CONF_ID].id}_event_table"
+    cg.add_global(cg.RawStatement(
+        f"static constexpr {PackedEventConfig} {table}[{STATUS_STATE_COUNT}] = {{\n"
+        + "".join(f"    {row},\n" for row in rows)
+        + "};"
+    ))
+    cg.add(var.set_event_table(cg.RawExpression(table)))
+    
+    # Status sources, registered in configuration order
+    for source in config[CONF_SOURCES]:
+        effect = source[CONF_EFFECT]
+        period = source.get(CONF_PERIOD, TimePeriod(milliseconds=1000))
+        packed = packed_config(source, True, EFFECTS[effect], period, source.get(CONF_DUTY, 0.5))
+        cg.Pvariable(source[CONF_ID], var.register_source(
+            source.get(CONF_NAME, source[CONF_ID].id),
+            getattr(StatusState, source[CONF_ABOVE].upper()),
+            source[CONF_PRIORITY],
+            cg.RawExpression(f"{PackedEventConfig}{packed}"),
+        ))
+    
+    # Only compile the effect renderers and state checks that some instance can reach;
+    # events disabled in every instance are compiled out entirely
+    enabled_events, effects = build_features(config)
+    _, own_effects = compiled_features(config)
+    cg.add_define("RGB_STATUS_LED_ENABLED_EVENTS", cg.RawExpression(f"0x{enabled_events:04X}"))
+    if "blink" in effects:
+        cg.add_define("RGB_STATUS_LED_USE_BLINK")
+    if "pulse" in effects:
+        cg.add_define("RGB_STATUS_LED_USE_PULSE")
+    if "code" in effects:
+        cg.add_define("RGB_STATUS_LED_USE_CODE")
+    if "timeline" in effects:
+        cg.add_define("RGB_STATUS_LED_USE_TIMELINE")
+    if "timeline" in own_effects:
+        cg.add(var.set_timeline_table(cg.RawExpression(generate_timelines(config))))
+    if "pattern" in effects:
+        cg.add_define("RGB_STATUS_LED_USE_PATTERN")
+    if "pattern" in own_effects:
+        cg.add(var.set_pattern_table(cg.RawExpression(generate_patterns(config))))
     
     # Configure global timing and behavior
-    cg.add(var.set_error_blink_speed(config[CONF_ERROR_BLINK_SPEED]))
-    cg.add(var.set_warning_blink_speed(config[CONF_WARNING_BLINK_SPEED]))
     cg.add(var.set_brightness(config[CONF_BRIGHTNESS]))
     cg.add(var.set_priority_mode(config[CONF_PRIORITY_MODE]))
     cg.add(var.set_ok_state_enabled(config[CONF_OK_STATE_ENABLED]))
+    cg.add(var.set_event_driven(config[CONF_EVENT_DRIVEN]))
+    cg.add(var.set_app_state_poll_interval(config[CONF_APP_STATE_POLL_INTERVAL]))
+    
+    # Optional loop cost instrumentation
+    if config[CONF_LOOP_STATS]:
+        cg.add_define("RGB_STATUS_LED_LOOP_STATS")
+        if CONF_LOOP_BUDGET in config:
+            cg.add(var.set_loop_budget(config[CONF_LOOP_BUDGET]))
+    
+    # Optional output correction table in flash, no powf() on the device
+    if config[CONF_OUTPUT_CORRECTION] != "none":
+        if config[CONF_OUTPUT_CORRECTION] == "cie":
+            curve = cie_lstar
+        else:
+            curve = lambda x: x ** config[CONF_OUTPUT_GAMMA]
+        values = [round(curve(i / CORRECTION_TABLE_STEPS) * 65535) for i in range(CORRECTION_TABLE_STEPS + 1)]
+        table = f"{config[CONF_ID].id}_correction_table"
+        cg.add_global(cg.RawStatement(
+            f"static constexpr uint16_t {table}[{CORRECTION_TABLE_STEPS + 1}] = {{"
+            + ", ".join(str(value) for value in values)
+            + "};"
+        ))
+        cg.add_define("RGB_STATUS_LED_CORRECTION")
+        cg.add(var.set_correction_table(cg.RawExpression(table)))
+    
+    # Optional temporal dithering for low-resolution outputs
+    if CONF_DITHER_BITS in config:
+        cg.add_define("RGB_STATUS_LED_DITHER")
+        cg.add(var.set_dither_bits(config[CONF_DITHER_BITS]))
+    
+    # Optional crossfade between states
+    if config[CONF_TRANSITION_LENGTH].total_milliseconds > 0:
+        cg.add_define("RGB_STATUS_LED_TRANSITION")
+        cg.add(var.set_transition_length(config[CONF_TRANSITION_LENGTH]))
+        cg.add(var.set_transition_max_fps(config[CONF_TRANSITION_MAX_FPS]))
+    
+    # Optional event to light latency instrumentation; the sensor implies the statistics
+    if config[CONF_LATENCY_STATS] or CONF_LATENCY_SENSOR in config:
+        cg.add_define("RGB_STATUS_LED_LATENCY")
+        if CONF_LATENCY_SENSOR in config:
+            sens = await sensor.new_sensor(config[CONF_LATENCY_SENSOR])
+            cg.add(var.set_latency_sensor(sens))
+    
+    # OTA state arrives through the OTA state callback; WiFi and API edges are read from
+    # their components (USE_WIFI / USE_API are defined by them when present)
+    if "ota" in CORE.config:
+        cg.add_define("USE_OTA_STATE_CALLBACK")
     
     # Enable the component in the build
     cg.add_define("USE_RGB_STATUS_LED")
+
+
+SOURCE_ACTION_SCHEMA = cv.maybe_simple_value({cv.Required(CONF_ID): cv.use_id(StatusSource)}, key=CONF_ID)
+
+
+@automation.register_action("rgb_status_led.source.raise", SourceRaiseAction, SOURCE_ACTION_SCHEMA)
+@automation.register_action("rgb_status_led.source.clear", SourceClearAction, SOURCE_ACTION_SCHEMA)
+async def source_action_to_code(config, action_id, template_arg, args):
+    source = await cg.get_variable(config[CONF_ID])
+    return cg.new_Pvariable(action_id, template_arg, source)
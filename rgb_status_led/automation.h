@@ -0,0 +1,32 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "rgb_status_led.h"
+
+namespace esphome {
+namespace rgb_status_led {
+
+/// `rgb_status_led.source.raise`: raise a status source
+template<typename... Ts> class SourceRaiseAction : public Action<Ts...> {
+ public:
+  explicit SourceRaiseAction(StatusSource *source) : source_(source) {}
+
+  void play(Ts... x) override { this->source_->raise(); }
+
+ protected:
+  StatusSource *source_;
+};
+
+/// `rgb_status_led.source.clear`: clear a status source
+template<typename... Ts> class SourceClearAction : public Action<Ts...> {
+ public:
+  explicit SourceClearAction(StatusSource *source) : source_(source) {}
+
+  void play(Ts... x) override { this->source_->clear(); }
+
+ protected:
+  StatusSource *source_;
+};
+
+}  // namespace rgb_status_led
+}  // namespace esphome
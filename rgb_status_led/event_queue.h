@@ -0,0 +1,85 @@
+#pragma once
+
+// Fixed-capacity multi-producer/single-consumer ring buffer.
+//
+// Lets tasks and callbacks outside the main loop (the OTA callback, driver
+// tasks) hand status events to the component without locks or allocation.
+// Like render.h it has no ESPHome or hardware dependencies.
+
+#include <atomic>
+#include <cstdint>
+
+namespace esphome {
+namespace rgb_status_led {
+
+/**
+ * Lock-free MPSC queue of up to N items (N a power of two, at most 128).
+ *
+ * push() may be called from any number of contexts at once, pop() from one
+ * consumer context. Producers claim a position by advancing head with a
+ * compare-and-swap; each slot carries a sequence number that says whether it
+ * is free for a given position or holds a published item, so the consumer
+ * never reads a slot a producer is still writing (bounded queue after Vyukov).
+ * Positions are free-running 32-bit counters; differences are taken signed.
+ */
+template<typename T, uint8_t N> class MpscQueue {
+  static_assert(N != 0 && (N & (N - 1)) == 0 && N <= 128, "capacity must be a power of two up to 128");
+
+ public:
+  MpscQueue() {
+    for (uint8_t i = 0; i < N; i++) {
+      this->slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Append an item; returns false and counts an overflow when the queue is full
+  bool push(const T &item) {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = this->slots_[head & (N - 1)];
+      int32_t lag = static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) - head);
+      if (lag == 0) {
+        // Free for this position; a failed exchange reloads head and tries again
+        if (this->head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+          slot.item = item;
+          slot.sequence.store(head + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lag < 0) {
+        // Still holds the item from one lap ago
+        this->overflows_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        head = this->head_.load(std::memory_order_relaxed);  // Another producer took this position
+      }
+    }
+  }
+
+  /// Remove the oldest item; returns false when the queue is empty or its oldest item is still being written
+  bool pop(T &item) {
+    Slot &slot = this->slots_[this->tail_ & (N - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != this->tail_ + 1) {
+      return false;
+    }
+    item = slot.item;
+    slot.sequence.store(this->tail_ + N, std::memory_order_release);  // Free for the next lap
+    this->tail_++;
+    return true;
+  }
+
+  /// Items dropped because the queue was full
+  uint32_t overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+
+ protected:
+  struct Slot {
+    T item{};
+    std::atomic<uint32_t> sequence{0};  ///< Position + 1 once published, position + N once consumed
+  };
+  Slot slots_[N];
+  std::atomic<uint32_t> head_{0};  ///< Next position to claim, advanced by producers
+  uint32_t tail_{0};               ///< Next position to read, only touched by the consumer
+  std::atomic<uint32_t> overflows_{0};
+};
+
+}  // namespace rgb_status_led
+}  // namespace esphome
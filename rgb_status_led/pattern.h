@@ -0,0 +1,134 @@
+#pragma once
+
+// Bytecode interpreter for custom status animations.
+//
+// Programs are compiled from the YAML pattern DSL by codegen and stored as
+// constant byte arrays in flash. The interpreter has a fixed-size state (no
+// heap), runs at most PATTERN_INSTRUCTION_BUDGET instructions per tick and,
+// like render.h, has no ESPHome or hardware dependencies.
+
+#include <cstdint>
+
+namespace esphome {
+namespace rgb_status_led {
+
+/// Pattern instructions; operands follow the opcode, 16-bit values little-endian
+enum PatternOp : uint8_t {
+  PATTERN_OP_COLOR = 1,             ///< r g b: set the output color (0-255 each)
+  PATTERN_OP_WAIT = 2,              ///< ms16: show the color for ms milliseconds
+  PATTERN_OP_REPEAT = 3,            ///< count: run the body up to the next END_REPEAT count times
+  PATTERN_OP_END_REPEAT = 4,        ///< addr16: jump back to the body at addr until the count runs out
+  PATTERN_OP_JUMP = 5,              ///< addr16: continue at addr
+  PATTERN_OP_JUMP_IF_INACTIVE = 6,  ///< state addr16: continue at addr unless the status condition is active
+};
+
+static const uint8_t PATTERN_MAX_DEPTH = 4;             ///< Nested repeat limit, checked by codegen
+static const uint8_t PATTERN_INSTRUCTION_BUDGET = 16;  ///< Instructions run per tick at most
+
+/// Constant bytecode program; execution restarts at the beginning after the last instruction
+struct Pattern {
+  const uint8_t *code;  ///< Bytecode (nullptr = no pattern)
+  uint16_t size;        ///< Bytecode length in bytes
+};
+
+class PatternVM {
+ public:
+  /// Start a program from the beginning
+  void reset(const Pattern *pattern, uint32_t now) {
+    this->pattern_ = pattern;
+    this->pc_ = 0;
+    this->depth_ = 0;
+    this->wait_until_ = now;
+    this->color_[0] = this->color_[1] = this->color_[2] = 0;
+  }
+
+  /**
+   * Run until the program waits or the instruction budget is used up.
+   *
+   * `conditions` holds the active status conditions, one bit per StatusState.
+   * Returns the milliseconds until the color can next change (0 = run again next tick).
+   */
+  uint32_t run(uint32_t now, uint32_t conditions) {
+    if (static_cast<int32_t>(this->wait_until_ - now) > 0) {
+      return this->wait_until_ - now;
+    }
+
+    const uint8_t *code = this->pattern_->code;
+    for (uint8_t budget = PATTERN_INSTRUCTION_BUDGET; budget > 0; budget--) {
+      if (this->pc_ >= this->pattern_->size) {
+        this->pc_ = 0;
+        this->depth_ = 0;
+      }
+      const uint8_t *op = code + this->pc_;
+      switch (op[0]) {
+        case PATTERN_OP_COLOR:
+          this->color_[0] = op[1];
+          this->color_[1] = op[2];
+          this->color_[2] = op[3];
+          this->pc_ += 4;
+          break;
+
+        case PATTERN_OP_WAIT: {
+          uint16_t ms = operand16(op + 1);
+          this->pc_ += 3;
+          if (ms == 0) {
+            break;
+          }
+          // Counted from the end of the previous wait so tick lateness doesn't add up over the program,
+          // a stall longer than the wait itself restarts the schedule
+          this->wait_until_ = now - this->wait_until_ < ms ? this->wait_until_ + ms : now + ms;
+          return this->wait_until_ - now;
+        }
+
+        case PATTERN_OP_REPEAT:
+          if (this->depth_ < PATTERN_MAX_DEPTH) {
+            this->counters_[this->depth_++] = op[1];
+          }
+          this->pc_ += 2;
+          break;
+
+        case PATTERN_OP_END_REPEAT:
+          if (this->depth_ != 0 && --this->counters_[this->depth_ - 1] != 0) {
+            this->pc_ = operand16(op + 1);
+          } else {
+            if (this->depth_ != 0) {
+              this->depth_--;
+            }
+            this->pc_ += 3;
+          }
+          break;
+
+        case PATTERN_OP_JUMP:
+          this->pc_ = operand16(op + 1);
+          break;
+
+        case PATTERN_OP_JUMP_IF_INACTIVE:
+          this->pc_ = (conditions & (1u << op[1])) != 0 ? this->pc_ + 4 : operand16(op + 2);
+          break;
+
+        default:
+          this->pc_ = this->pattern_->size;  // Unknown instruction, restart the program
+          break;
+      }
+    }
+
+    // Budget used up without a wait, continue on the next tick (codegen rejects loops that never wait)
+    return 0;
+  }
+
+  /// Color set by the last COLOR instruction (0-255 per channel)
+  const uint8_t *color() const { return this->color_; }
+
+ protected:
+  static uint16_t operand16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+  const Pattern *pattern_{nullptr};
+  uint16_t pc_{0};                         ///< Offset of the next instruction
+  uint8_t depth_{0};                       ///< Active repeat loops
+  uint8_t counters_[PATTERN_MAX_DEPTH]{};  ///< Remaining iterations per active repeat loop
+  uint8_t color_[3]{0, 0, 0};              ///< Current output color
+  uint32_t wait_until_{0};                 ///< End of the current wait
+};
+
+}  // namespace rgb_status_led
+}  // namespace esphome
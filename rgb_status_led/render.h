@@ -0,0 +1,161 @@
+#pragma once
+
+// Output rendering math shared by the RGB Status LED effects.
+//
+// Everything in here is pure integer/float arithmetic with no ESPHome or
+// hardware dependencies, so it can be compiled and exercised off-device.
+
+#include <cstdint>
+
+namespace esphome {
+namespace rgb_status_led {
+
+/// Convert a 0.0-1.0 level to 16 bits (0 = off, 65535 = full), clamping out-of-range values
+inline uint16_t quantize_level(float level) {
+  if (level < 0.0f) {
+    level = 0.0f;
+  } else if (level > 1.0f) {
+    level = 1.0f;
+  }
+  return static_cast<uint16_t>(level * 65535.0f + 0.5f);
+}
+
+/// Scale a 16-bit level by a 16-bit factor (level * factor / 65535) without a divide
+inline uint16_t scale_level(uint16_t level, uint32_t factor) {
+  return static_cast<uint16_t>((level * (factor + 1)) >> 16);
+}
+
+/// Whether a blink is in its on phase at `now`; `delay` receives the milliseconds until the next edge
+inline bool blink_phase_on(uint32_t now, uint32_t period, uint32_t on_time, uint32_t &delay) {
+  uint32_t phase = now % period;
+  bool on = phase < on_time;
+  delay = on ? on_time - phase : period - phase;
+  return on;
+}
+
+// Blink codes: `code` one-slot flashes separated by one dark slot, then a pause before repeating.
+static const uint8_t CODE_PAUSE_SLOTS = 4;  ///< Dark slots after the last flash
+static const uint8_t CODE_MAX = 14;         ///< Longest code that fits a 32-slot sequence
+
+/// Slot sequence for a blink code, bit i set when slot i is lit; `length` receives the slot count
+inline uint32_t blink_code_bits(uint8_t code, uint8_t &length) {
+  if (code > CODE_MAX) {
+    code = CODE_MAX;
+  }
+  uint32_t bits = 0;
+  for (uint8_t i = 0; i < code; i++) {
+    bits |= 1u << (2 * i);
+  }
+  length = 2 * code + CODE_PAUSE_SLOTS;
+  return bits;
+}
+
+/// Whether a blink code is lit at `now`; `delay` receives the milliseconds until the next slot
+inline bool code_phase_on(uint32_t now, uint32_t slot, uint32_t bits, uint8_t length, uint32_t &delay) {
+  uint32_t index = now / slot;
+  delay = slot - (now - index * slot);
+  return ((bits >> (index % length)) & 1u) != 0;
+}
+
+// Pulse waveform: quarter sine wave in 64 steps from 0 to pi/2, scaled to 16 bits.
+// Generated at compile time; the other three quadrants are mirrored from it.
+static const uint32_t PULSE_PERIOD = 2000;  ///< Pulse period in milliseconds
+static const uint8_t PULSE_TABLE_STEPS = 64;
+
+struct PulseTable {
+  uint16_t values[PULSE_TABLE_STEPS + 1];
+};
+
+constexpr double pulse_table_sin(double x) {
+  // Taylor series, converges well below 16-bit resolution on [0, pi/2]
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 10; n++) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr PulseTable make_pulse_table() {
+  PulseTable table{};
+  for (int i = 0; i <= PULSE_TABLE_STEPS; i++) {
+    table.values[i] = static_cast<uint16_t>(pulse_table_sin(i * 1.5707963267948966 / PULSE_TABLE_STEPS) * 65535.0 + 0.5);
+  }
+  return table;
+}
+
+static constexpr PulseTable PULSE_TABLE = make_pulse_table();
+static_assert(PULSE_TABLE.values[0] == 0 && PULSE_TABLE.values[PULSE_TABLE_STEPS] == 65535,
+              "pulse table must span the full 16-bit range");
+
+/// Interpolated quarter-wave lookup, x in [0, 0x4000] maps to sin(0..pi/2) in [0, 65535]
+inline uint32_t pulse_quarter_wave(uint32_t x) {
+  uint32_t index = x >> 8;
+  if (index >= PULSE_TABLE_STEPS) {
+    return PULSE_TABLE.values[PULSE_TABLE_STEPS];
+  }
+  uint32_t frac = x & 0xFF;
+  uint32_t a = PULSE_TABLE.values[index];
+  uint32_t b = PULSE_TABLE.values[index + 1];
+  return a + (((b - a) * frac) >> 8);
+}
+
+/// Pulse brightness (sin(2*pi*t/period) + 1) / 2 in 16 bits, integer-only
+inline uint16_t pulse_level(uint32_t now) {
+  // 16-bit phase: two quadrant bits followed by a 14-bit position in the quadrant
+  uint32_t phase = (now % PULSE_PERIOD) * 65536 / PULSE_PERIOD;
+  uint32_t x = phase & 0x3FFF;
+  uint32_t quadrant = phase >> 14;
+  uint32_t s = pulse_quarter_wave((quadrant & 1) ? 0x4000 - x : x);
+  return (quadrant & 2) ? (65535 - s) / 2 : (65535 + s) / 2;
+}
+
+/// 16-bit level between two 8-bit keyframe values, `frac` being the 16-bit position (0 = from, 65536 = to)
+inline uint16_t keyframe_level(uint8_t from, uint8_t to, uint32_t frac) {
+  int32_t delta = (static_cast<int32_t>(to) - from) * 257;
+  return static_cast<uint16_t>(from * 257 + ((delta * static_cast<int32_t>(frac >> 1)) >> 15));
+}
+
+// Output correction: a build-time table of CORRECTION_TABLE_STEPS + 1 entries mapping linear
+// 16-bit levels to corrected ones. 256 interpolated steps keep the error below one step of a
+// 12-bit PWM channel, the finest resolution these outputs reach in practice.
+static const uint16_t CORRECTION_TABLE_STEPS = 256;
+
+/// Corrected level for a linear 16-bit level: 8-bit table index plus 8-bit interpolation fraction
+inline uint16_t correct_level(const uint16_t *table, uint16_t level) {
+  if (level == 0xFFFF) {
+    return table[CORRECTION_TABLE_STEPS];  // Full on stays exactly full on
+  }
+  uint32_t index = level >> 8;
+  uint32_t frac = level & 0xFF;
+  uint32_t a = table[index];
+  uint32_t b = table[index + 1];
+  return static_cast<uint16_t>(b >= a ? a + (((b - a) * frac) >> 8) : a - (((a - b) * frac) >> 8));
+}
+
+/**
+ * Temporal dithering of a 16-bit level down to an output with `bits` of resolution (8-15).
+ *
+ * The part of the level below one output step is carried in `error` and added to the next
+ * frame, so over several frames the output averages to the requested level. Returns the
+ * chosen output step expanded back to 16 bits by bit replication, which the output maps
+ * onto exactly that step again.
+ */
+inline uint16_t dither_level(uint16_t level, uint8_t bits, uint16_t &error) {
+  const uint32_t max_step = (1u << bits) - 1;
+  // Level in output steps with a 16-bit fraction; level + (level >> 15) maps 65535 to exactly 1.0
+  uint32_t acc = (level + (level >> 15)) * max_step + error;
+  uint32_t step = acc >> 16;
+  error = static_cast<uint16_t>(acc & 0xFFFF);
+  const uint8_t shift = 16 - bits;
+  return static_cast<uint16_t>((step << shift) | (step >> (bits - shift)));
+}
+
+/// Part of a 16-bit level that falls between two steps of a `bits` output, as a 16-bit fraction of a step
+inline uint16_t dither_remainder(uint16_t level, uint8_t bits) {
+  return static_cast<uint16_t>((level + (level >> 15)) * ((1u << bits) - 1));
+}
+
+}  // namespace rgb_status_led
+}  // namespace esphome
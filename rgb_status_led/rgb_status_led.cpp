@@ -1,47 +1,127 @@
 #include "rgb_status_led.h"
+#include "render.h"
 #include "esphome/core/log.h"
-#include <cmath>
+#include <cstring>
 
 namespace esphome {
 namespace rgb_status_led {
 
 const char *const RGBStatusLED::TAG = "rgb_status_led";
 
+static const uint32_t BOOT_DURATION = 10000;      ///< Boot state shown for the first 10 seconds
+static const uint32_t OTA_BEGIN_DURATION = 500;   ///< Solid OTA_BEGIN before switching to OTA_PROGRESS
+static const uint32_t OTA_ERROR_DURATION = 10000; ///< OTA_ERROR shown for 10 seconds after a failed update
+static const uint8_t MAX_IMMEDIATE_RENDERS = 4;   ///< Setter-triggered renders per loop() before deferring
+
+static constexpr uint32_t state_bit(StatusState state) { return 1u << static_cast<uint8_t>(state); }
+
+static const char *const STATE_NAMES[STATUS_STATE_COUNT] = {
+    "NONE",    "OK",    "USER",    "WIFI_CONNECTED", "API_DISCONNECTED", "API_CONNECTED", "BOOT",
+    "WARNING", "ERROR", "OTA_END", "OTA_PROGRESS",   "OTA_BEGIN",        "OTA_ERROR",
+};
+
+const char *status_state_to_string(StatusState state) {
+  uint8_t index = static_cast<uint8_t>(state);
+  return index < STATUS_STATE_COUNT ? STATE_NAMES[index] : "UNKNOWN";
+}
+
+const PackedEventConfig DEFAULT_EVENT_TABLE[STATUS_STATE_COUNT] = {
+    {{false, {0.0f, 0.0f, 0.0f}, 1.0f, EffectType::NONE}, 1000, 500},   // NONE: off
+    {{true, {0.0f, 1.0f, 0.1f}, 1.0f, EffectType::NONE}, 1000, 500},    // OK: green solid
+    {{false, {0.0f, 0.0f, 0.0f}, 1.0f, EffectType::NONE}, 1000, 500},   // USER: managed by the light system
+    {{true, {0.7f, 0.7f, 0.7f}, 1.0f, EffectType::NONE}, 1000, 500},    // WIFI_CONNECTED: white solid
+    {{true, {1.0f, 1.0f, 0.0f}, 1.0f, EffectType::NONE}, 1000, 500},    // API_DISCONNECTED: yellow solid
+    {{true, {0.0f, 1.0f, 0.1f}, 1.0f, EffectType::NONE}, 1000, 500},    // API_CONNECTED: green solid
+    {{true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::NONE}, 1000, 500},    // BOOT: red solid
+    {{true, {1.0f, 0.5f, 0.0f}, 1.0f, EffectType::BLINK}, 1500, 250},   // WARNING: orange slow blink (17% duty)
+    {{true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::BLINK}, 250, 150},    // ERROR: red fast blink (60% duty)
+    {{true, {0.0f, 1.0f, 0.1f}, 1.0f, EffectType::NONE}, 1000, 500},    // OTA_END: green solid
+    {{true, {0.0f, 0.0f, 1.0f}, 1.0f, EffectType::BLINK}, 1000, 500},   // OTA_PROGRESS: blue blink
+    {{true, {0.0f, 0.0f, 1.0f}, 1.0f, EffectType::NONE}, 1000, 500},    // OTA_BEGIN: blue solid
+    {{true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::BLINK}, 1000, 500},   // OTA_ERROR: red blink
+};
+
 RGBStatusLED::RGBStatusLED() {
   // Initialize with boot state - device is starting up
   this->current_state_ = StatusState::BOOT;
   this->last_state_ = StatusState::NONE;
+  this->active_conditions_ = state_bit(StatusState::NONE) | state_bit(StatusState::OK) | state_bit(StatusState::BOOT);
 }
 
 void RGBStatusLED::setup() {
   ESP_LOGCONFIG(TAG, "Setting up RGB Status LED...");
   
   // Initialize outputs to off
-  this->set_rgb_output_(0.0f, 0.0f, 0.0f);
+  const uint16_t off[3] = {0, 0, 0};
+  this->write_levels_(millis(), off);
+  
+  // End the boot phase after its window
+  if ((ENABLED_EVENTS & state_bit(StatusState::BOOT)) != 0) {
+    this->set_timeout("boot", BOOT_DURATION, [this]() { this->set_condition_(StatusState::BOOT, false); });
+  }
   
-  // Mark boot start time
-  this->boot_complete_time_ = millis();
+#ifdef USE_OTA_STATE_CALLBACK
+  // OTA state changes arrive as edge events, no YAML automations needed
+  ota::get_global_ota_callback()->add_on_state_callback(
+      [this](ota::OTAState state, float progress, uint8_t error, ota::OTAComponent *comp) {
+        this->on_ota_state_(state, progress);
+      });
+#endif
+  
+#ifdef RGB_STATUS_LED_LATENCY
+  this->last_poll_us_ = micros();
+#endif
   
   ESP_LOGCONFIG(TAG, "RGB Status LED setup completed");
-  ESP_LOGCONFIG(TAG, "  Error blink speed: %ums (matches ESPHome)", this->error_blink_speed_);
-  ESP_LOGCONFIG(TAG, "  Warning blink speed: %ums (matches ESPHome)", this->warning_blink_speed_);
+  ESP_LOGCONFIG(TAG, "  Error blink speed: %ums (matches ESPHome)", this->state_config_(StatusState::ERROR).period);
+  ESP_LOGCONFIG(TAG, "  Warning blink speed: %ums (matches ESPHome)",
+                this->state_config_(StatusState::WARNING).period);
   ESP_LOGCONFIG(TAG, "  Brightness: %.1f%%", this->brightness_ * 100.0f);
   ESP_LOGCONFIG(TAG, "  Priority mode: %s", 
                 (this->priority_mode_ == PriorityMode::STATUS_PRIORITY) ? "Status" : "User");
+  ESP_LOGCONFIG(TAG, "  Event driven: %s", this->event_driven_ ? "YES" : "NO");
+  
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  this->set_interval("loop_stats", LOOP_STATS_INTERVAL, [this]() { this->log_loop_stats_(); });
+#endif
+#if defined(RGB_STATUS_LED_LATENCY) && defined(USE_SENSOR)
+  if (this->latency_sensor_ != nullptr) {
+    this->set_interval("latency", LATENCY_REPORT_INTERVAL, [this]() {
+      if (this->latency_.count != 0) {
+        this->latency_sensor_->publish_state(this->latency_.percentile(99));
+      }
+    });
+  }
+#endif
 }
 
 void RGBStatusLED::dump_config() {
   ESP_LOGCONFIG(TAG, "RGB Status LED:");
   ESP_LOGCONFIG(TAG, "  Priority Mode: %s", 
                 (this->priority_mode_ == PriorityMode::STATUS_PRIORITY) ? "Status Priority" : "User Priority");
-  ESP_LOGCONFIG(TAG, "  Error Color: R=%.1f, G=%.1f, B=%.1f", 
-                this->error_color_.r * 100.0f, this->error_color_.g * 100.0f, this->error_color_.b * 100.0f);
-  ESP_LOGCONFIG(TAG, "  Warning Color: R=%.1f, G=%.1f, B=%.1f", 
-                this->warning_color_.r * 100.0f, this->warning_color_.g * 100.0f, this->warning_color_.b * 100.0f);
-  ESP_LOGCONFIG(TAG, "  OK Color: R=%.1f, G=%.1f, B=%.1f", 
-                this->ok_color_.r * 100.0f, this->ok_color_.g * 100.0f, this->ok_color_.b * 100.0f);
-  ESP_LOGCONFIG(TAG, "  Boot Color: R=%.1f, G=%.1f, B=%.1f", 
-                this->boot_color_.r * 100.0f, this->boot_color_.g * 100.0f, this->boot_color_.b * 100.0f);
+  for (uint8_t i = 0; i < STATUS_STATE_COUNT; i++) {
+    const PackedEventConfig &event = this->states_[i];
+    if (!event.enabled() || (this->enabled_conditions_ & state_bit(static_cast<StatusState>(i))) == 0) {
+      continue;
+    }
+    ESP_LOGCONFIG(TAG, "  %s Color: R=%.1f, G=%.1f, B=%.1f", status_state_to_string(static_cast<StatusState>(i)),
+                  event.r * 100.0f / 255.0f, event.g * 100.0f / 255.0f, event.b * 100.0f / 255.0f);
+  }
+  for (const StatusSource *source : this->sources_) {
+    ESP_LOGCONFIG(TAG, "  Source '%s': above %s, priority %u, color R=%.1f, G=%.1f, B=%.1f", source->name_,
+                  status_state_to_string(source->above_), source->priority_, source->config_.r * 100.0f / 255.0f,
+                  source->config_.g * 100.0f / 255.0f, source->config_.b * 100.0f / 255.0f);
+  }
+  ESP_LOGCONFIG(TAG, "  Output writes: %u issued, %u suppressed", this->output_writes_,
+                this->output_writes_suppressed_);
+  ESP_LOGCONFIG(TAG, "  Queued events dropped: %u", this->events_.overflows());
+#ifdef RGB_STATUS_LED_LATENCY
+  ESP_LOGCONFIG(TAG, "  Event to light latency: %u samples, p50 <= %uus, p99 <= %uus", this->latency_.count,
+                this->latency_.percentile(50), this->latency_.percentile(99));
+#endif
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  ESP_LOGCONFIG(TAG, "  Loop statistics: every %us, budget %uus", LOOP_STATS_INTERVAL / 1000, this->loop_budget_us_);
+#endif
 }
 
 light::LightTraits RGBStatusLED::get_traits() {
@@ -50,6 +130,89 @@ light::LightTraits RGBStatusLED::get_traits() {
   return traits;
 }
 
+PackedEventConfig &RGBStatusLED::mutable_state_config_(StatusState state) {
+  // Runtime reconfiguration only: the constant table stays in flash until something has to change
+  if (this->owned_states_ == nullptr) {
+    this->owned_states_ = new PackedEventConfig[STATUS_STATE_COUNT];  // NOLINT(cppcoreguidelines-owning-memory)
+    for (uint8_t i = 0; i < STATUS_STATE_COUNT; i++) {
+      this->owned_states_[i] = this->states_[i];
+    }
+    this->states_ = this->owned_states_;
+  }
+  return this->owned_states_[static_cast<uint8_t>(state)];
+}
+
+void RGBStatusLED::set_event_table(const PackedEventConfig *table) {
+  this->states_ = table;
+  
+  // ENABLED_EVENTS is shared by every instance in the build; this table decides which of them this one shows
+  uint32_t enabled = state_bit(StatusState::NONE);
+  for (uint8_t i = 0; i < STATUS_STATE_COUNT; i++) {
+    if (table[i].enabled()) {
+      enabled |= state_bit(static_cast<StatusState>(i));
+    }
+  }
+  this->enabled_conditions_ = (enabled & ENABLED_EVENTS) | state_bit(StatusState::NONE);
+  this->invalidate_plan_();
+}
+
+void RGBStatusLED::set_event_config(StatusState state, const EventConfig &config) {
+  // Keep the entry's blink timing, it is configured separately
+  PackedEventConfig &entry = this->mutable_state_config_(state);
+  entry = PackedEventConfig(config, entry.period, entry.on_time, entry.phase, entry.code);
+  
+  // Events compiled out by codegen cannot be enabled at runtime
+  if (config.enabled) {
+    this->enabled_conditions_ |= state_bit(state) & ENABLED_EVENTS;
+  } else {
+    this->enabled_conditions_ &= ~state_bit(state);
+  }
+  this->invalidate_plan_();
+}
+
+void RGBStatusLED::set_error_blink_speed(uint32_t speed) {
+  // Stored as a 16-bit period that the blink phase is taken modulo, so 0 and larger values cannot be kept
+  if (speed == 0 || speed > 65535) {
+    ESP_LOGW(TAG, "Ignoring error blink speed of %ums, must be 1-65535ms", speed);
+    return;
+  }
+  PackedEventConfig &entry = this->mutable_state_config_(StatusState::ERROR);
+  entry.period = speed;
+  entry.on_time = speed * 60 / 100;  // 60% duty cycle
+  this->invalidate_plan_();
+}
+
+void RGBStatusLED::set_warning_blink_speed(uint32_t speed) {
+  if (speed == 0 || speed > 65535) {  // Same limits as set_error_blink_speed()
+    ESP_LOGW(TAG, "Ignoring warning blink speed of %ums, must be 1-65535ms", speed);
+    return;
+  }
+  PackedEventConfig &entry = this->mutable_state_config_(StatusState::WARNING);
+  entry.period = speed;
+  entry.on_time = speed / 6;  // 17% duty cycle, 250ms of 1500ms like ESPHome
+  this->invalidate_plan_();
+}
+
+void RGBStatusLED::set_blink_code(StatusState state, uint8_t code) {
+#ifdef RGB_STATUS_LED_USE_CODE
+  if (this->blink_code_(state) == code) {
+    return;
+  }
+  this->blink_codes_[static_cast<uint8_t>(state)] = code;
+  this->code_overrides_ |= state_bit(state);
+  this->invalidate_plan_();
+#endif
+}
+
+#ifdef RGB_STATUS_LED_USE_CODE
+uint8_t RGBStatusLED::blink_code_(StatusState state) const {
+  if (this->code_overrides_ & state_bit(state)) {
+    return this->blink_codes_[static_cast<uint8_t>(state)];
+  }
+  return this->state_config_(state).code;
+}
+#endif
+
 void RGBStatusLED::write_state(light::LightState *state) {
   // This is called when user controls the light
   if (this->priority_mode_ == PriorityMode::USER_PRIORITY) {
@@ -63,18 +226,102 @@ void RGBStatusLED::write_state(light::LightState *state) {
     // In status priority mode, mark user control but don't apply immediately
     this->user_control_active_ = true;
   }
+  
+  this->wake_();
 }
 
 void RGBStatusLED::loop() {
+  // Single time snapshot shared by state resolution and effect rendering
+  uint32_t now = millis();
+  this->immediate_renders_ = 0;
+  
   if (this->first_loop_) {
     this->first_loop_ = false;
-    this->last_state_change_ = millis();
+    this->last_state_change_ = now;
     return;
   }
   
-  this->update_state_();
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  uint32_t start_us = micros();
+  uint32_t writes = this->output_writes_;
+#endif
+  
+  this->update_state_(now);
+  
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  this->record_loop_stats_(micros() - start_us, this->output_writes_ - writes);
+#endif
+  
+  if (this->event_driven_) {
+    this->schedule_next_update_(now);
+  }
+}
+
+#ifdef RGB_STATUS_LED_LOOP_STATS
+void RGBStatusLED::record_loop_stats_(uint32_t elapsed_us, uint32_t writes) {
+  LoopStats &stats = this->loop_stats_[static_cast<uint8_t>(this->current_state_)];
+  stats.calls++;
+  stats.total_us += elapsed_us;
+  stats.writes += writes;
+  if (elapsed_us > stats.max_us) {
+    stats.max_us = elapsed_us;
+  }
+}
+
+void RGBStatusLED::log_loop_stats_() {
+  for (uint8_t i = 0; i < STATUS_STATE_COUNT; i++) {
+    LoopStats &stats = this->loop_stats_[i];
+    if (stats.calls == 0) {
+      continue;
+    }
+    
+    const char *name = status_state_to_string(static_cast<StatusState>(i));
+    uint32_t avg_ns = static_cast<uint32_t>(static_cast<uint64_t>(stats.total_us) * 1000 / stats.calls);
+    ESP_LOGD(TAG, "Loop %s: %u calls, avg %uns, max %uus, %.1f writes/s", name, stats.calls, avg_ns, stats.max_us,
+             stats.writes * 1000.0f / LOOP_STATS_INTERVAL);
+    
+    // Regression check against the configured budget
+    if (this->loop_budget_us_ != 0 && avg_ns > this->loop_budget_us_ * 1000) {
+      ESP_LOGW(TAG, "Loop %s: average %uns exceeds budget of %uus", name, avg_ns, this->loop_budget_us_);
+    }
+    
+    stats = LoopStats();
+  }
+}
+#endif
+
+#ifdef RGB_STATUS_LED_LATENCY
+void RGBStatusLED::mark_input_(uint32_t at_us) {
+  // Keep the earliest input since the last render, that is what the viewer is waiting on
+  if (!this->latency_pending_ || static_cast<int32_t>(at_us - this->latency_start_us_) < 0) {
+    this->latency_pending_ = true;
+    this->latency_start_us_ = at_us;
+  }
 }
 
+void RGBStatusLED::LatencyHistogram::record(uint32_t us) {
+  uint8_t bucket = us == 0 ? 0 : 31 - __builtin_clz(us);
+  if (bucket >= LATENCY_BUCKETS) {
+    bucket = LATENCY_BUCKETS - 1;
+  }
+  this->buckets[bucket]++;
+  this->count++;
+}
+
+uint32_t RGBStatusLED::LatencyHistogram::percentile(uint8_t pct) const {
+  // Upper bound of the bucket holding the requested rank
+  uint32_t rank = (static_cast<uint64_t>(this->count) * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += this->buckets[i];
+    if (seen >= rank && seen != 0) {
+      return (2u << i) - 1;
+    }
+  }
+  return 0;
+}
+#endif
+
 float RGBStatusLED::get_setup_priority() const { 
   return setup_priority::HARDWARE; 
 }
@@ -83,257 +330,878 @@ float RGBStatusLED::get_loop_priority() const {
   return 50.0f; 
 }
 
-void RGBStatusLED::update_state_() {
-  StatusState new_state = this->determine_status_state_();
+void RGBStatusLED::update_state_(uint32_t now) {
+  // Setters called while resolving (queued events, app and connection edges) are rendered by this pass
+  this->in_update_ = true;
+  this->drain_events_();
+#ifdef RGB_STATUS_LED_LATENCY
+  uint32_t poll_us = micros();
+#endif
+  this->update_app_state_();
+  this->update_connection_state_();
+#ifdef RGB_STATUS_LED_LATENCY
+  this->last_poll_us_ = poll_us;
+#endif
+  StatusState new_state = this->determine_status_state_(now);
+  const StatusSource *new_source = this->resolve_source_(new_state);
   
   // Check if state has changed
-  if (new_state != this->last_state_) {
+  bool state_changed = new_state != this->last_state_ || new_source != this->current_source_;
+  if (state_changed) {
     this->last_state_ = new_state;
-    this->last_state_change_ = millis();
+    this->current_source_ = new_source;
+    this->last_state_change_ = now;
     this->is_blink_on_ = false;  // Reset blink state
+    this->plan_dirty_ = true;
+  }
+  this->current_state_ = new_state;
+  
+  // Rebuild the render plan only when the state or its configuration changed
+  if (this->plan_dirty_) {
+    this->build_plan_(new_state, new_source);
+    this->plan_dirty_ = false;
   }
   
-  // Apply the current state
-  this->apply_state_(new_state);
+#ifdef RGB_STATUS_LED_TRANSITION
+  // Crossfade into the new state before its effect takes over
+  if (state_changed) {
+    this->start_fade_(now);
+  }
+  if (this->fade_frames_left_ != 0) {
+    this->apply_fade_(now);
+  } else
+#endif
+  {
+    // Render the current state
+    this->apply_effect_(now);
+  }
+  
+#ifdef RGB_STATUS_LED_LATENCY
+  // The new state's levels have just been written; inputs that left the state unchanged show nothing
+  if (this->latency_pending_) {
+    this->latency_pending_ = false;
+    if (state_changed) {
+      this->latency_.record(micros() - this->latency_start_us_);
+    }
+  }
+#endif
+  
+  this->in_update_ = false;
 }
 
-StatusState RGBStatusLED::determine_status_state_() {
+StatusState RGBStatusLED::determine_status_state_(uint32_t now) {
   // Check if we should show status or user control
-  if (!this->should_show_status_()) {
+  if (!this->should_show_status_(now)) {
     return StatusState::USER;
   }
   
-  // Priority 1: OTA operations (highest priority)
-  // OTA overrides everything including system errors during update
-  if (this->ota_active_) {
-    // During OTA, alternate between begin and progress states for visual feedback
-    // Show solid blue for 500ms, then blink to indicate activity
-    if (millis() - this->ota_progress_time_ < 500) {
-      return StatusState::OTA_BEGIN;
-    } else {
-      return StatusState::OTA_PROGRESS;
-    }
+  // Highest set bit is the highest priority active and enabled condition; NONE (bit 0) is always set.
+  // Disabled events never claim their priority, lower states show instead.
+  return static_cast<StatusState>(31 - __builtin_clz(this->active_conditions_ & this->enabled_conditions_));
+}
+
+void RGBStatusLED::set_condition_(StatusState state, bool active) {
+  uint32_t conditions = active ? (this->active_conditions_ | state_bit(state))
+                               : (this->active_conditions_ & ~state_bit(state));
+  if (conditions == this->active_conditions_) {
+    return;
   }
   
-  // Get ESPHome application state for native error/warning detection
-  uint32_t app_state = App.get_app_state();
+  this->active_conditions_ = conditions;
+  this->input_changed_();
+}
+
+StatusSource *RGBStatusLED::register_source(const char *name, StatusState above, uint8_t priority,
+                                            const PackedEventConfig &config) {
+  if (this->sources_.size() >= MAX_STATUS_SOURCES) {
+    ESP_LOGE(TAG, "Cannot register status source '%s', all %u slots are used", name, MAX_STATUS_SOURCES);
+    return nullptr;
+  }
   
-  // Priority 2: System errors (critical issues)
-  // These include configuration errors, hardware failures, etc.
-  if ((app_state & STATUS_LED_ERROR) != 0u) {
-    return StatusState::ERROR;
+  // Keep the list ordered by rank; on equal rank the earlier registration stays higher
+  auto *source = new StatusSource(this, name, above, priority, config);  // NOLINT(cppcoreguidelines-owning-memory)
+  auto it = this->sources_.begin();
+  while (it != this->sources_.end() && (*it)->rank_() < source->rank_()) {
+    ++it;
   }
+  this->sources_.insert(it, source);
   
-  // Priority 3: System warnings (non-critical issues)
-  // These include temporary sensor failures, connection issues, etc.
-  if ((app_state & STATUS_LED_WARNING) != 0u) {
-    return StatusState::WARNING;
+  // Slots above the insertion point moved up, renumber them and rebuild the bitmap
+  this->active_sources_ = 0;
+  for (uint8_t slot = 0; slot < this->sources_.size(); slot++) {
+    StatusSource *entry = this->sources_[slot];
+    entry->slot_ = slot;
+    if (entry->active_ && entry->config_.enabled()) {
+      this->active_sources_ |= 1u << slot;
+    }
+  }
+  return source;
+}
+
+StatusSource *RGBStatusLED::get_source(const char *name) const {
+  for (StatusSource *source : this->sources_) {
+    if (strcmp(source->name_, name) == 0) {
+      return source;
+    }
+  }
+  return nullptr;
+}
+
+void StatusSource::set_active(bool active) { this->parent_->set_source_(this, active); }
+
+void RGBStatusLED::set_source_(StatusSource *source, bool active) {
+  if (source->active_ == active) {
+    return;
   }
   
-  // Priority 4: Boot phase (device initialization)
-  // Show boot state for first 10 seconds after startup
-  if (millis() - this->boot_complete_time_ < 10000) {
-    return StatusState::BOOT;
+  // Disabled sources never claim their slot, like disabled events
+  source->active_ = active;
+  if (active && source->config_.enabled()) {
+    this->active_sources_ |= 1u << source->slot_;
+  } else {
+    this->active_sources_ &= ~(1u << source->slot_);
+  }
+  this->input_changed_();
+}
+
+const StatusSource *RGBStatusLED::resolve_source_(StatusState state) const {
+  // Sources never override user control
+  if (this->active_sources_ == 0 || state == StatusState::USER) {
+    return nullptr;
   }
   
-  // Priority 5: Home Assistant API connection
-  // Highest level of connectivity - full integration
-  if (this->api_connected_) {
-    return StatusState::API_CONNECTED;
+  // The highest ranked active source has the highest anchor, if it does not beat the state no source does
+  const StatusSource *source = this->sources_[31 - __builtin_clz(this->active_sources_)];
+  return static_cast<uint8_t>(source->above_) >= static_cast<uint8_t>(state) ? source : nullptr;
+}
+
+void RGBStatusLED::input_changed_() {
+#ifdef RGB_STATUS_LED_LATENCY
+  this->mark_input_(micros());
+#endif
+  this->wake_();
+  this->render_now_();
+}
+
+void RGBStatusLED::render_now_() {
+  // Not from inside update_state_(), not before the outputs are live, and bounded per loop so a
+  // burst of setter calls cannot turn into a burst of output writes
+  if (this->in_update_ || this->batch_depth_ != 0 || this->first_loop_ ||
+      this->immediate_renders_ >= MAX_IMMEDIATE_RENDERS) {
+    return;
   }
   
-  // Priority 6: WiFi connection
-  // Network connectivity but no Home Assistant connection
-  if (this->wifi_connected_) {
-    return StatusState::WIFI_CONNECTED;
+  // Only worth a pass when the displayed state changes; effects keep their timing in loop()
+  uint32_t now = millis();
+  StatusState state = this->determine_status_state_(now);
+  if (state == this->last_state_ && this->resolve_source_(state) == this->current_source_) {
+    return;
   }
   
-  // Priority 7: Everything is OK (lowest priority)
-  // No specific state to show - device is running normally
-  // If OK state is disabled, return NONE to turn LED off
-  if (this->ok_state_enabled_) {
-    return StatusState::OK;
-  } else {
-    return StatusState::NONE;
+  this->immediate_renders_++;
+  this->update_state_(now);
+}
+
+void RGBStatusLED::end_batch_() {
+  // Setters that change several conditions must not show the states in between
+  if (--this->batch_depth_ == 0) {
+    this->render_now_();
   }
 }
 
-bool RGBStatusLED::should_show_status_() {
-  if (this->priority_mode_ == PriorityMode::USER_PRIORITY) {
-    return false;  // User always has priority
+void RGBStatusLED::set_ota_active_(bool active) {
+  const uint32_t ota_bits = state_bit(StatusState::OTA_BEGIN) | state_bit(StatusState::OTA_PROGRESS);
+  if ((ENABLED_EVENTS & ota_bits) == 0) {
+    return;
   }
   
-  // In status priority mode, show status unless user is actively controlling
-  // and we've been in OK state for more than 30 seconds
-  if (this->user_control_active_ && this->last_state_ == StatusState::OK) {
-    return (millis() - this->last_state_change_ < 30000);
+  if (!active) {
+    this->cancel_timeout("ota_begin");
+    this->begin_batch_();
+    this->set_condition_(StatusState::OTA_BEGIN, false);
+    this->set_condition_(StatusState::OTA_PROGRESS, false);
+    this->end_batch_();
+    return;
   }
   
-  return true;
+  // During OTA, show solid blue for 500ms, then blink to indicate activity
+  this->set_condition_(StatusState::OTA_BEGIN, true);
+  this->set_timeout("ota_begin", OTA_BEGIN_DURATION, [this]() {
+    this->begin_batch_();
+    this->set_condition_(StatusState::OTA_BEGIN, false);
+    this->set_condition_(StatusState::OTA_PROGRESS, true);
+    this->end_batch_();
+  });
 }
 
-void RGBStatusLED::apply_effect_(const EventConfig &config) {
-  if (!config.enabled) {
-    // Event disabled - turn off LED
-    this->set_rgb_output_(0.0f, 0.0f, 0.0f);
-    this->is_blink_on_ = false;
+void RGBStatusLED::update_app_state_() {
+  // Nothing to track when both error and warning are compiled out
+  if ((ENABLED_EVENTS & (state_bit(StatusState::ERROR) | state_bit(StatusState::WARNING))) == 0) {
     return;
   }
   
-  // Apply brightness override if specified (1.0 = use global brightness)
-  float brightness_scale = (config.brightness == 1.0f) ? this->brightness_ : config.brightness;
+  // ESPHome application state for native error/warning detection, only acted on when it changes
+  uint32_t app_state = App.get_app_state() & (STATUS_LED_ERROR | STATUS_LED_WARNING);
+  if (app_state == this->last_app_state_) {
+    return;
+  }
   
-  // Apply the specified effect
-  if (config.effect == "none") {
-    this->apply_none_effect_(config);
-  } else if (config.effect == "blink") {
-    // Determine blink timing based on context (error vs warning vs other)
-    uint32_t period = 1000;  // Default 1 second
-    uint32_t on_time = 500;  // Default 50% duty
-    
-    // Use ESPHome-compatible timing for error/warning
-    if (&config == &this->error_config_) {
-      period = this->error_blink_speed_;
-      on_time = period * 3 / 5;  // 60% duty cycle
-    } else if (&config == &this->warning_config_) {
-      period = this->warning_blink_speed_;
-      on_time = period / 6;  // 17% duty cycle
+  this->last_app_state_ = app_state;
+#ifdef RGB_STATUS_LED_LATENCY
+  this->mark_input_(this->last_poll_us_);  // Changed at some point since the previous poll
+#endif
+  this->set_condition_(StatusState::ERROR, (app_state & STATUS_LED_ERROR) != 0u);
+  this->set_condition_(StatusState::WARNING, (app_state & STATUS_LED_WARNING) != 0u);
+}
+
+void RGBStatusLED::update_connection_state_() {
+  // Connection flags are plain member reads; only edges reach the setters, so manual setter calls stick
+#ifdef USE_WIFI
+  if ((ENABLED_EVENTS & state_bit(StatusState::WIFI_CONNECTED)) != 0) {
+    bool wifi = wifi::global_wifi_component != nullptr && wifi::global_wifi_component->is_connected();
+    if (wifi != this->wifi_seen_) {
+      this->wifi_seen_ = wifi;
+#ifdef RGB_STATUS_LED_LATENCY
+      this->mark_input_(this->last_poll_us_);
+#endif
+      this->set_wifi_connected(wifi);
+    }
+  }
+#endif
+#ifdef USE_API
+  const uint32_t api_bits = state_bit(StatusState::API_CONNECTED) | state_bit(StatusState::API_DISCONNECTED);
+  if ((ENABLED_EVENTS & api_bits) != 0) {
+    bool api = api::global_api_server != nullptr && api::global_api_server->is_connected();
+    if (api != this->api_seen_) {
+      this->api_seen_ = api;
+#ifdef RGB_STATUS_LED_LATENCY
+      this->mark_input_(this->last_poll_us_);
+#endif
+      this->set_api_connected(api);
     }
-    
-    this->apply_blink_effect_(config, period, on_time);
-  } else if (config.effect == "pulse") {
-    this->apply_pulse_effect_(config);
-  } else {
-    // Unknown effect - default to solid
-    this->apply_none_effect_(config);
   }
+#endif
 }
 
-void RGBStatusLED::apply_none_effect_(const EventConfig &config) {
-  // Apply brightness override if specified
-  float brightness_scale = (config.brightness == 1.0f) ? this->brightness_ : config.brightness;
-  this->set_rgb_output_(config.color, brightness_scale);
-  this->is_blink_on_ = false;
+void RGBStatusLED::set_wifi_connected(bool connected) {
+  this->begin_batch_();
+  this->set_condition_(StatusState::WIFI_CONNECTED, connected);
+  if (!connected) {
+    this->set_api_connected(false);  // No API without WiFi
+  }
+  this->end_batch_();
 }
 
-void RGBStatusLED::apply_blink_effect_(const EventConfig &config, uint32_t period, uint32_t on_time) {
-  uint32_t now = millis();
-  
-  // Apply brightness override if specified
-  float brightness_scale = (config.brightness == 1.0f) ? this->brightness_ : config.brightness;
+void RGBStatusLED::set_api_connected(bool connected) {
+  // API_DISCONNECTED marks a lost connection, not one that was never made
+  bool was_connected = (this->active_conditions_ & state_bit(StatusState::API_CONNECTED)) != 0;
+  this->begin_batch_();
+  this->set_condition_(StatusState::API_CONNECTED, connected);
+  if (connected) {
+    this->set_condition_(StatusState::API_DISCONNECTED, false);
+  } else if (was_connected) {
+    this->set_condition_(StatusState::API_DISCONNECTED, true);
+  }
+  this->end_batch_();
+}
+
+void RGBStatusLED::set_ota_begin() {
+  this->cancel_timeout("ota_error");
+  this->begin_batch_();
+  this->set_condition_(StatusState::OTA_END, false);
+  this->set_condition_(StatusState::OTA_ERROR, false);
+  this->set_ota_active_(true);
+  this->end_batch_();
+}
+
+void RGBStatusLED::set_ota_progress(float progress) {
+  // Progress without a begin (e.g. a missed callback) still shows the OTA as running
+  const uint32_t ota_bits = state_bit(StatusState::OTA_BEGIN) | state_bit(StatusState::OTA_PROGRESS);
+  if ((this->active_conditions_ & ota_bits) == 0) {
+    this->set_condition_(StatusState::OTA_PROGRESS, true);
+  }
+}
+
+void RGBStatusLED::set_ota_end() {
+  this->begin_batch_();
+  this->set_ota_active_(false);
+  this->set_condition_(StatusState::OTA_END, true);
+  this->end_batch_();
+}
+
+void RGBStatusLED::set_ota_error() {
+  this->begin_batch_();
+  this->set_ota_active_(false);
+  this->set_condition_(StatusState::OTA_ERROR, true);
+  this->end_batch_();
+  this->set_timeout("ota_error", OTA_ERROR_DURATION, [this]() { this->set_condition_(StatusState::OTA_ERROR, false); });
+}
+
+bool RGBStatusLED::post_event(StatusEventType type, uint8_t value) {
+  StatusEvent event;
+  event.type = type;
+  event.value = value;
+#ifdef RGB_STATUS_LED_LATENCY
+  event.posted_us = micros();
+#endif
+  if (!this->events_.push(event)) {
+    return false;
+  }
   
-  if ((now % period) < on_time) {
-    if (!this->is_blink_on_) {
-      this->set_rgb_output_(config.color, brightness_scale);
-      this->is_blink_on_ = true;
-    }
-  } else {
-    if (this->is_blink_on_) {
-      this->set_rgb_output_(0.0f, 0.0f, 0.0f);
-      this->is_blink_on_ = false;
+  // May run outside the main loop, so only use the any-context wake-up
+  if (this->event_driven_) {
+    this->enable_loop_soon_any_context();
+  }
+  return true;
+}
+
+void RGBStatusLED::drain_events_() {
+  StatusEvent event;
+  while (this->events_.pop(event)) {
+#ifdef RGB_STATUS_LED_LATENCY
+    this->mark_input_(event.posted_us);  // Includes the time spent in the queue
+#endif
+    switch (event.type) {
+      case StatusEventType::WIFI_CONNECTED:
+        this->set_wifi_connected(event.value != 0);
+        break;
+      case StatusEventType::API_CONNECTED:
+        this->set_api_connected(event.value != 0);
+        break;
+      case StatusEventType::OTA_BEGIN:
+        this->set_ota_begin();
+        break;
+      case StatusEventType::OTA_PROGRESS:
+        this->set_ota_progress(event.value);
+        break;
+      case StatusEventType::OTA_END:
+        this->set_ota_end();
+        break;
+      case StatusEventType::OTA_ERROR:
+        this->set_ota_error();
+        break;
+      case StatusEventType::ERROR_CODE:
+        this->set_error_code(event.value);
+        break;
     }
   }
 }
 
-void RGBStatusLED::apply_pulse_effect_(const EventConfig &config) {
-  uint32_t now = millis();
+#ifdef USE_OTA_STATE_CALLBACK
+void RGBStatusLED::on_ota_state_(ota::OTAState state, float progress) {
+  // Web server and HTTP OTA report from their own task, so go through the event queue
+  switch (state) {
+    case ota::OTA_STARTED:
+      this->ota_progress_posted_ = false;
+      this->post_event(StatusEventType::OTA_BEGIN);
+      break;
+    case ota::OTA_IN_PROGRESS:
+      // Progress arrives many times per second while the loop may be blocked by the upload;
+      // one event is enough and leaves room for the final result
+      if (!this->ota_progress_posted_) {
+        this->ota_progress_posted_ = this->post_event(StatusEventType::OTA_PROGRESS, static_cast<uint8_t>(progress));
+      }
+      break;
+    case ota::OTA_COMPLETED:
+      this->post_event(StatusEventType::OTA_END);
+      break;
+    case ota::OTA_ABORT:
+    case ota::OTA_ERROR:
+      this->post_event(StatusEventType::OTA_ERROR);
+      break;
+  }
+}
+#endif
+
+uint32_t RGBStatusLED::compute_next_update_delay_(uint32_t now) {
+  // Effects that change every frame (pulse) need every loop
+  if (this->effect_delay_ == 0) {
+    return 0;
+  }
   
-  // Apply brightness override if specified
-  float brightness_scale = (config.brightness == 1.0f) ? this->brightness_ : config.brightness;
+  // App state (error/warning) has no change callback, so never sleep longer than the poll interval
+  uint32_t delay = this->app_state_poll_interval_;
+  if (this->effect_delay_ < delay) {
+    delay = this->effect_delay_;
+  }
   
-  // Create a smooth pulse effect over 2 seconds
-  uint32_t pulse_period = 2000;
-  float phase = (now % pulse_period) / float(pulse_period);
+#ifdef RGB_STATUS_LED_DITHER
+  // A level between two output steps is only right on average, keep producing frames
+  if (this->dither_active_ && this->plan_.active && DITHER_FRAME_INTERVAL < delay) {
+    delay = DITHER_FRAME_INTERVAL;
+  }
+#endif
   
-  // Use sine wave for smooth pulsing
-  float pulse_brightness = (sin(phase * 2 * M_PI) + 1.0f) / 2.0f;
-  float final_brightness = brightness_scale * pulse_brightness;
+  // User control timeout in should_show_status_(); boot and OTA transitions arm their own timeouts
+  if (this->user_control_active_ && this->last_state_ == StatusState::OK) {
+    uint32_t since_change = now - this->last_state_change_;
+    if (since_change < 30000 && 30000 - since_change < delay) {
+      delay = 30000 - since_change;
+    }
+  }
   
-  this->set_rgb_output_(config.color, final_brightness);
-  this->is_blink_on_ = (pulse_brightness > 0.5f);
+  return delay;
 }
 
-void RGBStatusLED::apply_state_(StatusState state) {
-  this->current_state_ = state;
+void RGBStatusLED::schedule_next_update_(uint32_t now) {
+  uint32_t delay = this->compute_next_update_delay_(now);
+  if (delay == 0) {
+    return;  // Keep looping
+  }
   
-  // Apply the appropriate event configuration based on state
-  switch (state) {
-    case StatusState::ERROR:
-      this->apply_effect_(this->error_config_);
-      break;
-      
-    case StatusState::WARNING:
-      this->apply_effect_(this->warning_config_);
+  this->set_timeout("update", delay, [this]() { this->enable_loop(); });
+  this->disable_loop();
+}
+
+void RGBStatusLED::wake_() {
+  if (this->event_driven_) {
+    this->enable_loop();
+  }
+}
+
+void RGBStatusLED::invalidate_plan_() {
+  this->plan_dirty_ = true;
+  this->wake_();
+}
+
+bool RGBStatusLED::should_show_status_(uint32_t now) {
+  if (this->priority_mode_ == PriorityMode::USER_PRIORITY) {
+    return false;  // User always has priority
+  }
+  
+  // In status priority mode, show status unless user is actively controlling
+  // and we've been in OK state for more than 30 seconds
+  if (this->user_control_active_ && this->last_state_ == StatusState::OK) {
+    return (now - this->last_state_change_ < 30000);
+  }
+  
+  return true;
+}
+
+void RGBStatusLED::apply_effect_(uint32_t now) {
+  this->effect_delay_ = NO_DEADLINE;  // Effects that animate override this
+  
+  if (!this->plan_.active) {
+    // User control - don't interfere, the light state will be managed by the light system
+    return;
+  }
+  
+  // Only effects used by an enabled event in the YAML are compiled in
+  switch (this->plan_.effect) {
+#ifdef RGB_STATUS_LED_USE_BLINK
+    case EffectType::BLINK:
+      this->apply_blink_effect_(now);
       break;
+#endif
       
-    case StatusState::BOOT:
-      this->apply_effect_(this->boot_config_);
+#ifdef RGB_STATUS_LED_USE_PULSE
+    case EffectType::PULSE:
+      this->apply_pulse_effect_(now);
       break;
+#endif
       
-    case StatusState::WIFI_CONNECTED:
-      this->apply_effect_(this->wifi_connected_config_);
+#ifdef RGB_STATUS_LED_USE_CODE
+    case EffectType::CODE:
+      this->apply_code_effect_(now);
       break;
+#endif
       
-    case StatusState::API_CONNECTED:
-      this->apply_effect_(this->api_connected_config_);
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+    case EffectType::TIMELINE:
+      this->apply_timeline_effect_(now);
       break;
+#endif
       
-    case StatusState::API_DISCONNECTED:
-      this->apply_effect_(this->api_disconnected_config_);
+#ifdef RGB_STATUS_LED_USE_PATTERN
+    case EffectType::PATTERN:
+      this->apply_pattern_effect_(now);
       break;
+#endif
       
-    case StatusState::OTA_BEGIN:
-      this->apply_effect_(this->ota_begin_config_);
+    case EffectType::NONE:
+    default:
+      this->apply_none_effect_(now);
       break;
-      
-    case StatusState::OTA_PROGRESS:
-      this->apply_effect_(this->ota_progress_config_);
+  }
+}
+
+void RGBStatusLED::apply_none_effect_(uint32_t now) {
+  this->write_levels_(now, this->plan_.on);
+  this->is_blink_on_ = false;
+}
+
+#ifdef RGB_STATUS_LED_USE_BLINK
+void RGBStatusLED::apply_blink_effect_(uint32_t now) {
+  this->is_blink_on_ = blink_phase_on(now + this->plan_.phase, this->plan_.period, this->plan_.on_time, this->effect_delay_);
+  
+  // Unchanged levels are filtered by the output write cache
+  this->write_levels_(now, this->is_blink_on_ ? this->plan_.on : this->plan_.off);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_USE_PULSE
+void RGBStatusLED::apply_pulse_effect_(uint32_t now) {
+  // Smooth sine pulse over 2 seconds from the fixed-point table
+  uint32_t pulse_brightness = pulse_level(now + this->plan_.phase);
+  
+  uint16_t levels[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    levels[i] = scale_level(this->plan_.on[i], pulse_brightness);
+  }
+  
+  this->write_levels_(now, levels);
+  this->is_blink_on_ = (pulse_brightness > 32767);
+  this->effect_delay_ = 0;  // Continuous animation
+}
+#endif
+
+#ifdef RGB_STATUS_LED_USE_CODE
+void RGBStatusLED::apply_code_effect_(uint32_t now) {
+  // Same levels and phase as blink, the on/off decision comes from the precomputed slot sequence
+  this->is_blink_on_ = code_phase_on(now + this->plan_.phase, this->plan_.code_slot, this->plan_.code_bits,
+                                     this->plan_.code_length, this->effect_delay_);
+  this->write_levels_(now, this->is_blink_on_ ? this->plan_.on : this->plan_.off);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+void RGBStatusLED::apply_timeline_effect_(uint32_t now) {
+  const Timeline &timeline = *this->plan_.timeline;
+  if (this->keyframe_index_ == KEYFRAME_RESTART) {
+    this->keyframe_index_ = 0;
+    this->keyframe_start_ = now;
+    this->keyframe_rate_ = 0xFFFFFFFFu / timeline.keyframes[0].duration;
+  }
+  
+  // Advance the cached cursor; a tick normally crosses at most one keyframe
+  uint32_t elapsed = now - this->keyframe_start_;
+  if (elapsed >= timeline.keyframes[this->keyframe_index_].duration) {
+    // Skip whole cycles after a long sleep, the cursor lands on the same keyframe
+    if (elapsed >= timeline.total) {
+      uint32_t cycles = elapsed - elapsed % timeline.total;
+      this->keyframe_start_ += cycles;
+      elapsed -= cycles;
+    }
+    while (elapsed >= timeline.keyframes[this->keyframe_index_].duration) {
+      uint16_t duration = timeline.keyframes[this->keyframe_index_].duration;
+      elapsed -= duration;
+      this->keyframe_start_ += duration;
+      this->keyframe_index_ = (this->keyframe_index_ + 1) % timeline.count;
+    }
+    this->keyframe_rate_ = 0xFFFFFFFFu / timeline.keyframes[this->keyframe_index_].duration;
+  }
+  
+  const Keyframe &to = timeline.keyframes[this->keyframe_index_];
+  uint16_t levels[3];
+  if (to.interpolation == Keyframe::LINEAR) {
+    const Keyframe &from = timeline.keyframes[(this->keyframe_index_ + timeline.count - 1) % timeline.count];
+    // 32-bit rate keeps the truncation below one 16-bit step, so the keyframe reaches its target
+    uint32_t frac = static_cast<uint32_t>((static_cast<uint64_t>(elapsed) * this->keyframe_rate_) >> 16);
+    levels[0] = keyframe_level(from.r, to.r, frac);
+    levels[1] = keyframe_level(from.g, to.g, frac);
+    levels[2] = keyframe_level(from.b, to.b, frac);
+    this->effect_delay_ = 0;  // Continuous animation
+  } else {
+    levels[0] = to.r * 257;
+    levels[1] = to.g * 257;
+    levels[2] = to.b * 257;
+    this->effect_delay_ = to.duration - elapsed;
+  }
+  
+  for (uint8_t i = 0; i < 3; i++) {
+    levels[i] = scale_level(levels[i], this->plan_.scale);
+  }
+  this->write_levels_(now, levels);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_USE_PATTERN
+void RGBStatusLED::apply_pattern_effect_(uint32_t now) {
+  if (this->pattern_restart_) {
+    this->pattern_restart_ = false;
+    this->pattern_vm_.reset(this->plan_.pattern, now);
+  }
+  
+  // Bounded run: stops at the next wait or after the per-tick instruction budget
+  this->effect_delay_ = this->pattern_vm_.run(now, this->active_conditions_);
+  
+  const uint8_t *color = this->pattern_vm_.color();
+  uint16_t levels[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    levels[i] = scale_level(color[i] * 257, this->plan_.scale);
+  }
+  this->write_levels_(now, levels);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_TRANSITION
+void RGBStatusLED::start_fade_(uint32_t now) {
+  if (!this->plan_.active) {
+    this->fade_frames_left_ = 0;  // User control, the light system handles its own transitions
+    return;
+  }
+  
+  uint32_t frames = this->transition_length_ / this->fade_frame_interval_;
+  if (frames == 0) {
+    frames = 1;
+  }
+  
+  // Aim at what the effect shows when it takes over on the last frame, not at its full color
+  uint16_t target[3];
+  this->handover_levels_(now + (frames - 1) * this->fade_frame_interval_, target);
+  
+  // Fixed-point (16.16) per-frame increments from the levels currently emitted to the handover levels
+  for (uint8_t i = 0; i < 3; i++) {
+    int64_t distance = (static_cast<int64_t>(target[i]) - this->emitted_level_[i]) << 16;
+    this->fade_level_[i] = static_cast<uint32_t>(this->emitted_level_[i]) << 16;
+    this->fade_step_[i] = static_cast<int32_t>(distance / static_cast<int64_t>(frames));
+  }
+  this->fade_frames_left_ = frames;
+  this->fade_last_frame_ = now - this->fade_frame_interval_;  // First frame renders immediately
+}
+
+void RGBStatusLED::apply_fade_(uint32_t now) {
+  // Limit output writes to the configured fade frame rate
+  uint32_t since_frame = now - this->fade_last_frame_;
+  if (since_frame < this->fade_frame_interval_) {
+    this->effect_delay_ = this->fade_frame_interval_ - since_frame;
+    return;
+  }
+  this->fade_last_frame_ = now;
+  
+  // Last frame hands over to the state's effect
+  if (--this->fade_frames_left_ == 0) {
+    this->apply_effect_(now);
+    return;
+  }
+  
+  uint16_t levels[3];
+  for (uint8_t i = 0; i < 3; i++) {
+    this->fade_level_[i] += static_cast<uint32_t>(this->fade_step_[i]);
+    levels[i] = this->fade_level_[i] >> 16;
+  }
+  this->write_levels_(now, levels);
+  this->effect_delay_ = this->fade_frame_interval_;
+}
+
+void RGBStatusLED::handover_levels_(uint32_t at, uint16_t levels[3]) {
+  const uint16_t *solid = this->plan_.on;
+  uint32_t delay;
+  switch (this->plan_.effect) {
+#ifdef RGB_STATUS_LED_USE_BLINK
+    case EffectType::BLINK:
+      if (!blink_phase_on(at + this->plan_.phase, this->plan_.period, this->plan_.on_time, delay)) {
+        solid = this->plan_.off;
+      }
       break;
+#endif
       
-    case StatusState::OTA_ERROR:
-      this->apply_effect_(this->ota_error_config_);
-      break;
+#ifdef RGB_STATUS_LED_USE_PULSE
+    case EffectType::PULSE: {
+      uint32_t pulse_brightness = pulse_level(at + this->plan_.phase);
+      for (uint8_t i = 0; i < 3; i++) {
+        levels[i] = scale_level(this->plan_.on[i], pulse_brightness);
+      }
+      return;
+    }
+#endif
       
-    case StatusState::OK:
-      this->apply_effect_(this->ok_config_);
+#ifdef RGB_STATUS_LED_USE_CODE
+    case EffectType::CODE:
+      if (!code_phase_on(at + this->plan_.phase, this->plan_.code_slot, this->plan_.code_bits,
+                         this->plan_.code_length, delay)) {
+        solid = this->plan_.off;
+      }
       break;
+#endif
       
-    case StatusState::NONE:
-      // LED off (used when OK state is disabled)
-      this->set_rgb_output_(0.0f, 0.0f, 0.0f);
-      this->is_blink_on_ = false;
-      break;
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+    case EffectType::TIMELINE: {
+      // Playback starts on the first keyframe; a linear one starts from the last keyframe's color
+      const Timeline &timeline = *this->plan_.timeline;
+      const Keyframe &first =
+          timeline.keyframes[timeline.keyframes[0].interpolation == Keyframe::LINEAR ? timeline.count - 1 : 0];
+      const uint8_t color[3] = {first.r, first.g, first.b};
+      for (uint8_t i = 0; i < 3; i++) {
+        levels[i] = scale_level(color[i] * 257, this->plan_.scale);
+      }
+      return;
+    }
+#endif
       
-    case StatusState::USER:
-      // User control - don't interfere, the light state will be managed by the light system
-      this->is_blink_on_ = false;
-      break;
+#ifdef RGB_STATUS_LED_USE_PATTERN
+    case EffectType::PATTERN: {
+      // A copy of the interpreter runs up to the program's first wait
+      PatternVM probe = this->pattern_vm_;
+      if (this->pattern_restart_) {
+        probe.reset(this->plan_.pattern, at);
+      }
+      probe.run(at, this->active_conditions_);
+      for (uint8_t i = 0; i < 3; i++) {
+        levels[i] = scale_level(probe.color()[i] * 257, this->plan_.scale);
+      }
+      return;
+    }
+#endif
       
+    case EffectType::NONE:
     default:
-      // Turn off
-      this->set_rgb_output_(0.0f, 0.0f, 0.0f);
-      this->is_blink_on_ = false;
       break;
   }
+  for (uint8_t i = 0; i < 3; i++) {
+    levels[i] = solid[i];
+  }
 }
+#endif
 
-void RGBStatusLED::set_rgb_output_(const RGBColor &color, float brightness_scale) {
-  this->set_rgb_output_(color.r, color.g, color.b, brightness_scale);
+void RGBStatusLED::build_plan_(StatusState state, const StatusSource *source) {
+  RenderPlan plan;
+  
+  // User control - the light state will be managed by the light system
+  if (state == StatusState::USER) {
+    this->plan_ = plan;
+    return;
+  }
+  
+  // Everything else drives the outputs; NONE and disabled events stay off
+  plan.active = true;
+  const PackedEventConfig &config = source != nullptr ? source->config_ : this->state_config_(state);
+  if (!config.enabled()) {
+    this->plan_ = plan;
+    return;
+  }
+  
+  // Apply brightness override if specified (255 = use global brightness), on top of global brightness
+  float brightness_scale = (config.brightness == 255) ? this->brightness_ : config.brightness / 255.0f;
+  float final_brightness = this->brightness_ * brightness_scale / 255.0f;
+  const uint8_t color[3] = {config.r, config.g, config.b};
+  for (uint8_t i = 0; i < 3; i++) {
+    plan.on[i] = quantize_level(color[i] * final_brightness);
+  }
+  
+  plan.effect = config.effect();
+  plan.period = config.period;
+  plan.on_time = config.on_time;
+  plan.phase = config.phase;
+  
+#ifdef RGB_STATUS_LED_USE_CODE
+  if (plan.effect == EffectType::CODE) {
+    uint8_t code = source != nullptr ? config.code : this->blink_code_(state);
+    plan.code_bits = blink_code_bits(code, plan.code_length);
+    plan.code_slot = config.period >= 2 ? config.period / 2 : 1;
+  }
+#endif
+  
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+  // Timelines carry their own colors, only the brightness is taken from the event
+  if (plan.effect == EffectType::TIMELINE) {
+    const Timeline *timeline = this->timelines_ != nullptr && source == nullptr
+                                   ? &this->timelines_[static_cast<uint8_t>(state)]
+                                   : nullptr;
+    if (timeline == nullptr || timeline->count == 0) {
+      plan.effect = EffectType::NONE;
+    } else {
+      plan.timeline = timeline;
+      plan.scale = quantize_level(255.0f * final_brightness);
+      // Restart only for a different timeline, a brightness change keeps the playback position
+      if (this->plan_.timeline != timeline) {
+        this->keyframe_index_ = KEYFRAME_RESTART;
+      }
+    }
+  }
+#endif
+  
+#ifdef RGB_STATUS_LED_USE_PATTERN
+  // Patterns set their own colors, only the brightness is taken from the event
+  if (plan.effect == EffectType::PATTERN) {
+    const Pattern *pattern = this->patterns_ != nullptr && source == nullptr
+                                 ? &this->patterns_[static_cast<uint8_t>(state)]
+                                 : nullptr;
+    if (pattern == nullptr || pattern->size == 0) {
+      plan.effect = EffectType::NONE;
+    } else {
+      plan.pattern = pattern;
+      plan.scale = quantize_level(255.0f * final_brightness);
+      if (this->plan_.pattern != pattern) {
+        this->pattern_restart_ = true;
+      }
+    }
+  }
+#endif
+  
+  this->plan_ = plan;
 }
 
-void RGBStatusLED::set_rgb_output_(float r, float g, float b, float brightness_scale) {
-  float final_brightness = this->brightness_ * brightness_scale;
+void RGBStatusLED::write_levels_(uint32_t now, const uint16_t levels[3]) {
+#ifdef RGB_STATUS_LED_DITHER
+  if (this->dither_bits_ != 0) {
+    // Frames follow the loop's time snapshot, so a replay through update_at() dithers the same way
+    this->dither_advance_ = now - this->dither_frame_ >= DITHER_FRAME_INTERVAL;
+    if (this->dither_advance_) {
+      this->dither_frame_ = now;
+    }
+    this->dither_active_ = false;
+  }
+#endif
+#ifdef RGB_STATUS_LED_TRANSITION
+  for (uint8_t i = 0; i < 3; i++) {
+    this->emitted_level_[i] = levels[i];
+  }
+#endif
+  this->write_channel_(0, this->red_output_, levels[0]);
+  this->write_channel_(1, this->green_output_, levels[1]);
+  this->write_channel_(2, this->blue_output_, levels[2]);
+}
+
+void RGBStatusLED::write_channel_(uint8_t channel, output::FloatOutput *output, uint16_t level) {
+  if (output == nullptr) {
+    return;
+  }
   
-  if (this->red_output_ != nullptr) {
-    this->red_output_->set_level(r * final_brightness);
+#ifdef RGB_STATUS_LED_CORRECTION
+  // Perceptual correction from the build-time table, constant cost per write; the define is build-wide,
+  // instances without `output_correction` have no table
+  if (this->correction_table_ != nullptr) {
+    level = correct_level(this->correction_table_, level);
   }
-  if (this->green_output_ != nullptr) {
-    this->green_output_->set_level(g * final_brightness);
+#endif
+  
+#ifdef RGB_STATUS_LED_DITHER
+  // Carry the sub-step remainder into the next frame on low-resolution outputs
+  if (this->dither_bits_ != 0) {
+    level = this->dither_channel_(channel, level);
   }
-  if (this->blue_output_ != nullptr) {
-    this->blue_output_->set_level(b * final_brightness);
+#endif
+  
+  if (level == this->last_level_[channel]) {
+    this->output_writes_suppressed_++;
+    return;
+  }
+  
+  this->last_level_[channel] = level;
+  this->output_writes_++;
+  output->set_level(level / 65535.0f);
+}
+
+#ifdef RGB_STATUS_LED_DITHER
+uint16_t RGBStatusLED::dither_channel_(uint8_t channel, uint16_t level) {
+  // The remainder only moves on once per frame, so every render within a frame picks the same step
+  // and the average does not depend on how often loop() runs
+  if (this->dither_advance_) {
+    this->dither_error_[channel] = this->dither_next_[channel];
+  }
+  uint16_t error = this->dither_error_[channel];
+  uint16_t step = dither_level(level, this->dither_bits_, error);
+  this->dither_next_[channel] = error;
+  
+  // Levels on or right next to a step would only flip after hundreds of frames, not worth waking up for
+  uint16_t remainder = dither_remainder(level, this->dither_bits_);
+  if (remainder >= DITHER_MIN_REMAINDER && remainder <= 65536 - DITHER_MIN_REMAINDER) {
+    this->dither_active_ = true;
   }
+  return step;
 }
+#endif
 
 }  // namespace rgb_status_led
 }  // namespace esphome
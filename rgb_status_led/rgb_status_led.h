@@ -1,11 +1,27 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
 #include "esphome/core/hal.h"
 #include "esphome/components/output/float_output.h"
 #include "esphome/components/light/light_output.h"
 #include "esphome/core/application.h"
+#include "event_queue.h"
+#include "pattern.h"
+#ifdef USE_WIFI
+#include "esphome/components/wifi/wifi_component.h"
+#endif
+#ifdef USE_API
+#include "esphome/components/api/api_server.h"
+#endif
+#ifdef USE_OTA_STATE_CALLBACK
+#include "esphome/components/ota/ota_backend.h"
+#endif
+#if defined(RGB_STATUS_LED_LATENCY) && defined(USE_SENSOR)
+#include "esphome/components/sensor/sensor.h"
+#endif
 #include <string>
+#include <vector>
 
 namespace esphome {
 namespace rgb_status_led {
@@ -16,20 +32,63 @@ namespace rgb_status_led {
  * States with higher numerical values have higher priority.
  * The component will always show the highest priority active state.
  */
-enum class StatusState {
-  NONE = 0,           ///< No specific state (fallback)
-  OK = 1,             ///< Everything is normal (lowest priority)
-  USER = 2,           ///< User is manually controlling the LED
-  WIFI_CONNECTED = 3, ///< WiFi is connected but API is not
-  API_CONNECTED = 4,  ///< Home Assistant API is connected
-  BOOT = 5,           ///< Device is booting (first 10 seconds)
-  WARNING = 6,        ///< System warnings (slow blink)
-  ERROR = 7,          ///< System errors (fast blink)
-  OTA_PROGRESS = 8,   ///< OTA in progress (blink)
-  OTA_BEGIN = 9,      ///< OTA started (solid)
-  OTA_ERROR = 10      ///< OTA error (highest priority)
+enum class StatusState : uint8_t {
+  NONE = 0,              ///< No specific state (fallback)
+  OK = 1,                ///< Everything is normal (lowest priority)
+  USER = 2,              ///< User is manually controlling the LED
+  WIFI_CONNECTED = 3,    ///< WiFi is connected but API is not
+  API_DISCONNECTED = 4,  ///< Home Assistant API connection was lost
+  API_CONNECTED = 5,     ///< Home Assistant API is connected
+  BOOT = 6,              ///< Device is booting (first 10 seconds)
+  WARNING = 7,           ///< System warnings (slow blink)
+  ERROR = 8,             ///< System errors (fast blink)
+  OTA_END = 9,           ///< OTA completed
+  OTA_PROGRESS = 10,     ///< OTA in progress (blink)
+  OTA_BEGIN = 11,        ///< OTA started (solid)
+  OTA_ERROR = 12         ///< OTA error (highest priority)
 };
 
+/// Number of StatusState values
+static const uint8_t STATUS_STATE_COUNT = 13;
+
+// Without codegen defines, compile in every event and effect
+#ifndef RGB_STATUS_LED_ENABLED_EVENTS
+#define RGB_STATUS_LED_ENABLED_EVENTS 0x1FFF
+#define RGB_STATUS_LED_USE_BLINK
+#define RGB_STATUS_LED_USE_PULSE
+#endif
+
+/// Events compiled into the firmware, one bit per StatusState (union of the YAML `enabled` options of all instances)
+static constexpr uint32_t ENABLED_EVENTS = RGB_STATUS_LED_ENABLED_EVENTS;
+
+/// Human readable name of a status state for logging
+const char *status_state_to_string(StatusState state);
+
+/**
+ * @brief Status inputs that can be posted from outside the main loop
+ */
+enum class StatusEventType : uint8_t {
+  WIFI_CONNECTED = 0,  ///< value: connected
+  API_CONNECTED = 1,   ///< value: connected
+  OTA_BEGIN = 2,
+  OTA_PROGRESS = 3,    ///< value: progress in percent
+  OTA_END = 4,
+  OTA_ERROR = 5,
+  ERROR_CODE = 6,      ///< value: blink code for the ERROR state
+};
+
+/// Status input queued by post_event()
+struct StatusEvent {
+  StatusEventType type{StatusEventType::WIFI_CONNECTED};
+  uint8_t value{0};
+#ifdef RGB_STATUS_LED_LATENCY
+  uint32_t posted_us{0};  ///< micros() when posted, for latency statistics
+#endif
+};
+
+/// Capacity of the cross-task status event queue
+static const uint8_t STATUS_EVENT_QUEUE_SIZE = 16;
+
 /**
  * @brief Priority modes for status vs user control
  */
@@ -38,6 +97,31 @@ enum class PriorityMode {
   USER_PRIORITY = 1     ///< User control takes priority over status indications
 };
 
+/**
+ * @brief Visual effects an event can use
+ * 
+ * Resolved from the YAML effect name at code generation time.
+ */
+enum class EffectType : uint8_t {
+  NONE = 0,     ///< Solid color
+  BLINK = 1,    ///< On/off blink
+  PULSE = 2,    ///< Smooth sine pulse
+  TIMELINE = 3, ///< Keyframe timeline
+  PATTERN = 4,  ///< Bytecode pattern program
+  CODE = 5      ///< Blink a numeric code, then pause
+};
+
+/**
+ * @brief RGB color structure
+ * 
+ * Stores RGB values as floats (0.0 to 1.0) for consistency
+ * with ESPHome's color system.
+ */
+struct RGBColor {
+  float r, g, b;
+  constexpr RGBColor(float red = 0, float green = 0, float blue = 0) : r(red), g(green), b(blue) {}
+};
+
 /**
  * @brief Event configuration structure for different states
  */
@@ -45,13 +129,155 @@ struct EventConfig {
   bool enabled{true};                    ///< Whether this event is enabled
   RGBColor color{0.0f, 0.0f, 0.0f};     ///< Color for this event
   float brightness{1.0f};                ///< Brightness override (0.0-1.0, 1.0 = use global)
-  std::string effect{"none"};            ///< Effect to apply ("none", "blink", "pulse", etc.)
+  EffectType effect{EffectType::NONE};   ///< Effect to apply
   
-  EventConfig() = default;
-  EventConfig(bool en, const RGBColor &col, float bright = 1.0f, const std::string &eff = "none")
+  constexpr EventConfig() = default;
+  constexpr EventConfig(bool en, const RGBColor &col, float bright = 1.0f, EffectType eff = EffectType::NONE)
     : enabled(en), color(col), brightness(bright), effect(eff) {}
 };
 
+/**
+ * @brief Compact storage form of an event configuration plus its blink timing
+ * 
+ * 8-bit color channels and brightness, the effect and enabled flag packed into
+ * one byte, the blink code, and blink timing as 16-bit period, on-time and phase
+ * offset in milliseconds. Packed once at configuration time; only read when a render plan is built.
+ */
+struct PackedEventConfig {
+  static const uint8_t FLAG_ENABLED = 0x80;  ///< Event is enabled
+  static const uint8_t EFFECT_MASK = 0x0F;   ///< Low bits hold the EffectType
+
+  uint8_t r{0};             ///< Red channel (0-255)
+  uint8_t g{0};             ///< Green channel (0-255)
+  uint8_t b{0};             ///< Blue channel (0-255)
+  uint8_t brightness{255};  ///< Brightness override (255 = 1.0 = use global)
+  uint8_t flags{0};         ///< EffectType and FLAG_ENABLED
+  uint8_t code{0};          ///< Number of blinks shown by EffectType::CODE
+  uint16_t period{1000};    ///< Blink period in milliseconds
+  uint16_t on_time{500};    ///< Blink on-time in milliseconds, precomputed from the duty cycle
+  uint16_t phase{0};        ///< Offset into the effect cycle in milliseconds
+
+  constexpr PackedEventConfig() = default;
+  constexpr PackedEventConfig(const EventConfig &config, uint16_t period, uint16_t on_time, uint16_t phase = 0,
+                              uint8_t code = 0)
+      : r(pack_unit(config.color.r)),
+        g(pack_unit(config.color.g)),
+        b(pack_unit(config.color.b)),
+        brightness(pack_unit(config.brightness)),
+        flags(static_cast<uint8_t>((config.enabled ? FLAG_ENABLED : 0) | static_cast<uint8_t>(config.effect))),
+        code(code),
+        period(period),
+        on_time(on_time),
+        phase(phase) {}
+
+  bool enabled() const { return (this->flags & FLAG_ENABLED) != 0; }
+  EffectType effect() const { return static_cast<EffectType>(this->flags & EFFECT_MASK); }
+
+  /// Convert a 0.0-1.0 value to 0-255, clamping out-of-range values
+  static constexpr uint8_t pack_unit(float value) {
+    return value <= 0.0f ? 0 : value >= 1.0f ? 255 : static_cast<uint8_t>(value * 255.0f + 0.5f);
+  }
+};
+static_assert(sizeof(PackedEventConfig) <= 12, "PackedEventConfig must stay within 12 bytes per event");
+
+/**
+ * @brief One step of a keyframe timeline
+ * 
+ * Over `duration` the output moves from the previous keyframe's color to this one
+ * (linear) or shows this color for the whole step (step). Colors are 8-bit at full
+ * scale; the event brightness is applied when rendering.
+ */
+struct Keyframe {
+  static const uint8_t STEP = 0;    ///< Hold this keyframe's color
+  static const uint8_t LINEAR = 1;  ///< Interpolate from the previous keyframe's color
+
+  uint16_t duration;      ///< Milliseconds spent in this keyframe (non-zero)
+  uint8_t r, g, b;        ///< Target color (0-255)
+  uint8_t interpolation;  ///< STEP or LINEAR
+};
+
+/// Constant keyframe list played in a loop by EffectType::TIMELINE
+struct Timeline {
+  const Keyframe *keyframes;  ///< Keyframes in playback order (nullptr = no timeline)
+  uint8_t count;              ///< Number of keyframes
+  uint32_t total;             ///< Sum of all keyframe durations in milliseconds
+};
+
+/// ESPHome-compatible event configurations and blink timing, used when codegen provides no table
+extern const PackedEventConfig DEFAULT_EVENT_TABLE[STATUS_STATE_COUNT];
+
+/**
+ * @brief Precomputed rendering parameters for the displayed state
+ * 
+ * Built once when the displayed state or its configuration changes, so the
+ * per-tick path only has to pick a phase and emit the stored levels.
+ * Levels are 16-bit (0 = off, 65535 = full) with all brightness scaling applied.
+ */
+struct RenderPlan {
+  bool active{false};                   ///< Whether the component drives the outputs (false for USER)
+  EffectType effect{EffectType::NONE};  ///< Effect to render
+  uint16_t on[3]{0, 0, 0};              ///< Per-channel level while on
+  uint16_t off[3]{0, 0, 0};             ///< Per-channel level while off
+  uint32_t period{0};                   ///< Blink period in milliseconds
+  uint32_t on_time{0};                  ///< Blink on-time in milliseconds
+  uint32_t phase{0};                    ///< Offset added to the time before picking the effect phase
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+  const Timeline *timeline{nullptr};    ///< Keyframes for EffectType::TIMELINE
+#endif
+#ifdef RGB_STATUS_LED_USE_PATTERN
+  const Pattern *pattern{nullptr};      ///< Program for EffectType::PATTERN
+#endif
+#ifdef RGB_STATUS_LED_USE_CODE
+  uint32_t code_bits{0};                ///< Blink code sequence, one bit per slot (bit 0 first)
+  uint8_t code_length{0};               ///< Slots in the sequence
+  uint32_t code_slot{0};                ///< Slot length in milliseconds (half the blink period)
+#endif
+#if defined(RGB_STATUS_LED_USE_TIMELINE) || defined(RGB_STATUS_LED_USE_PATTERN)
+  uint16_t scale{0};                    ///< Brightness applied to effect-provided colors (16-bit)
+#endif
+};
+
+class RGBStatusLED;
+
+/**
+ * @brief Handle to a status source registered with RGBStatusLED::register_source()
+ * 
+ * A source is a named condition with its own event configuration, for inputs the
+ * built-in states do not cover (battery low, stale sensor, MQTT down, ...). It ranks
+ * just above the built-in state given at registration: it shows while no higher
+ * built-in state is active, and among sources the higher priority wins.
+ * raise() and clear() must be called from the main loop.
+ */
+class StatusSource {
+ public:
+  StatusSource(RGBStatusLED *parent, const char *name, StatusState above, uint8_t priority,
+               const PackedEventConfig &config)
+      : parent_(parent), name_(name), config_(config), above_(above), priority_(priority) {}
+
+  void raise() { this->set_active(true); }
+  void clear() { this->set_active(false); }
+  void set_active(bool active);
+  bool is_active() const { return this->active_; }
+  const char *get_name() const { return this->name_; }
+
+ protected:
+  friend class RGBStatusLED;
+
+  /// Sort key: built-in state first, then priority
+  uint16_t rank_() const { return static_cast<uint16_t>((static_cast<uint8_t>(this->above_) << 8) | this->priority_); }
+
+  RGBStatusLED *parent_;
+  const char *name_;
+  PackedEventConfig config_;  ///< How the source is shown; timeline and pattern effects are not available
+  StatusState above_;         ///< Built-in state this source ranks directly above
+  uint8_t priority_;          ///< Order among sources above the same built-in state (higher wins)
+  uint8_t slot_{0};           ///< Bit in the registry's active source bitmap
+  bool active_{false};
+};
+
+/// Maximum number of registered status sources, one bit each in a 32-bit bitmap
+static const uint8_t MAX_STATUS_SOURCES = 32;
+
 /**
  * @brief RGB Status LED Component
  * 
@@ -78,22 +304,60 @@ class RGBStatusLED : public light::LightOutput, public Component {
   float get_setup_priority() const override;
   float get_loop_priority() const override;
 
+  /// Run one state resolution and render pass at an injected time (milliseconds), for replay and benchmarking
+  void update_at(uint32_t now) { this->update_state_(now); }
+
   // Light output interface
   light::LightTraits get_traits() override;
   void write_state(light::LightState *state) override;
 
   // Event configuration methods
-  void set_error_config(const EventConfig &config) { error_config_ = config; }
-  void set_warning_config(const EventConfig &config) { warning_config_ = config; }
-  void set_ok_config(const EventConfig &config) { ok_config_ = config; }
-  void set_boot_config(const EventConfig &config) { boot_config_ = config; }
-  void set_wifi_connected_config(const EventConfig &config) { wifi_connected_config_ = config; }
-  void set_api_connected_config(const EventConfig &config) { api_connected_config_ = config; }
-  void set_api_disconnected_config(const EventConfig &config) { api_disconnected_config_ = config; }
-  void set_ota_begin_config(const EventConfig &config) { ota_begin_config_ = config; }
-  void set_ota_progress_config(const EventConfig &config) { ota_progress_config_ = config; }
-  void set_ota_end_config(const EventConfig &config) { ota_end_config_ = config; }
-  void set_ota_error_config(const EventConfig &config) { ota_error_config_ = config; }
+  /// Use a constant table of STATUS_STATE_COUNT entries indexed by StatusState (not copied, must outlive the component)
+  void set_event_table(const PackedEventConfig *table);
+  void set_event_config(StatusState state, const EventConfig &config);
+  void set_error_config(const EventConfig &config) { this->set_event_config(StatusState::ERROR, config); }
+  void set_warning_config(const EventConfig &config) { this->set_event_config(StatusState::WARNING, config); }
+  void set_ok_config(const EventConfig &config) { this->set_event_config(StatusState::OK, config); }
+  void set_boot_config(const EventConfig &config) { this->set_event_config(StatusState::BOOT, config); }
+  void set_wifi_connected_config(const EventConfig &config) { this->set_event_config(StatusState::WIFI_CONNECTED, config); }
+  void set_api_connected_config(const EventConfig &config) { this->set_event_config(StatusState::API_CONNECTED, config); }
+  void set_api_disconnected_config(const EventConfig &config) { this->set_event_config(StatusState::API_DISCONNECTED, config); }
+  void set_ota_begin_config(const EventConfig &config) { this->set_event_config(StatusState::OTA_BEGIN, config); }
+  void set_ota_progress_config(const EventConfig &config) { this->set_event_config(StatusState::OTA_PROGRESS, config); }
+  void set_ota_end_config(const EventConfig &config) { this->set_event_config(StatusState::OTA_END, config); }
+  void set_ota_error_config(const EventConfig &config) { this->set_event_config(StatusState::OTA_ERROR, config); }
+
+  // Status inputs. WiFi and API connection edges are picked up from those components when present,
+  // OTA state arrives through the OTA state callback; these setters remain for manual use.
+  void set_wifi_connected(bool connected);
+  void set_api_connected(bool connected);
+  void set_ota_begin();
+  void set_ota_progress(float progress = 0.0f);
+  void set_ota_end();
+  void set_ota_error();
+
+  /**
+   * Queue a status input from another task or callback; applied at the start of the next update.
+   * 
+   * Lock-free and allocation-free; any number of tasks and callbacks may post at the same time.
+   * Returns false (and counts the drop) when the queue is full.
+   */
+  bool post_event(StatusEventType type, uint8_t value = 0);
+  uint32_t get_events_dropped() const { return events_.overflows(); }  ///< Events lost to a full queue
+
+  /**
+   * Register a status source shown directly above the built-in state `above`.
+   * 
+   * The name is not copied and must outlive the component. Returns the handle used to
+   * raise and clear the source, or nullptr when MAX_STATUS_SOURCES are registered already.
+   */
+  StatusSource *register_source(const char *name, StatusState above, uint8_t priority,
+                                const PackedEventConfig &config);
+  /// Register a source with default blink timing (1000ms period, 50% duty)
+  StatusSource *register_source(const char *name, StatusState above, uint8_t priority, const EventConfig &config) {
+    return this->register_source(name, above, priority, PackedEventConfig(config, 1000, 500));
+  }
+  StatusSource *get_source(const char *name) const;  ///< Registered source by name, nullptr if unknown
 
   // Output configuration
   void set_red_output(output::FloatOutput *output) { red_output_ = output; }
@@ -101,13 +365,52 @@ class RGBStatusLED : public light::LightOutput, public Component {
   void set_blue_output(output::FloatOutput *output) { blue_output_ = output; }
 
   // Global configuration
-  void set_error_blink_speed(uint32_t speed) { error_blink_speed_ = speed; }
-  void set_warning_blink_speed(uint32_t speed) { warning_blink_speed_ = speed; }
-  void set_brightness(float brightness) { brightness_ = brightness; }
+  void set_error_blink_speed(uint32_t speed);
+  void set_warning_blink_speed(uint32_t speed);
+  /// Number of blinks shown by a state using the code effect (0-14)
+  void set_blink_code(StatusState state, uint8_t code);
+  void set_error_code(uint8_t code) { this->set_blink_code(StatusState::ERROR, code); }
+  void set_brightness(float brightness) { brightness_ = brightness; this->invalidate_plan_(); }
   void set_priority_mode(const std::string &mode) {
     priority_mode_ = (mode == "user") ? PriorityMode::USER_PRIORITY : PriorityMode::STATUS_PRIORITY;
   }
-  void set_ok_state_enabled(bool enabled) { ok_state_enabled_ = enabled; }
+  void set_ok_state_enabled(bool enabled) { this->set_condition_(StatusState::OK, enabled); }
+  void set_event_driven(bool event_driven) { event_driven_ = event_driven; }
+  void set_app_state_poll_interval(uint32_t interval) { app_state_poll_interval_ = interval; }
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+  /// Keyframe timelines indexed by StatusState, STATUS_STATE_COUNT entries (not copied, must outlive the component)
+  void set_timeline_table(const Timeline *table) { timelines_ = table; this->invalidate_plan_(); }
+#endif
+#ifdef RGB_STATUS_LED_USE_PATTERN
+  /// Pattern programs indexed by StatusState, STATUS_STATE_COUNT entries (not copied, must outlive the component)
+  void set_pattern_table(const Pattern *table) { patterns_ = table; this->invalidate_plan_(); }
+#endif
+#ifdef RGB_STATUS_LED_CORRECTION
+  /// Output correction table of CORRECTION_TABLE_STEPS + 1 entries (not copied, must outlive the component)
+  void set_correction_table(const uint16_t *table) { correction_table_ = table; }
+#endif
+#ifdef RGB_STATUS_LED_DITHER
+  void set_dither_bits(uint8_t bits) { dither_bits_ = bits; }
+#endif
+#ifdef RGB_STATUS_LED_TRANSITION
+  void set_transition_length(uint32_t length) { transition_length_ = length; }
+  void set_transition_max_fps(uint32_t fps) { fade_frame_interval_ = fps >= 1000 ? 1 : 1000 / fps; }
+#endif
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  void set_loop_budget(uint32_t budget_us) { loop_budget_us_ = budget_us; }
+#endif
+#if defined(RGB_STATUS_LED_LATENCY) && defined(USE_SENSOR)
+  /// Publishes the p99 event to light latency in microseconds every minute
+  void set_latency_sensor(sensor::Sensor *sensor) { latency_sensor_ = sensor; }
+#endif
+
+  // Output write statistics
+  uint32_t get_output_writes() const { return output_writes_; }                        ///< set_level() calls issued
+  uint32_t get_output_writes_suppressed() const { return output_writes_suppressed_; }  ///< Unchanged writes skipped
+#ifdef RGB_STATUS_LED_LATENCY
+  /// Upper bound in microseconds of the pct-th percentile event to light latency since boot (0 = none yet)
+  uint32_t get_latency_percentile(uint8_t pct) const { return latency_.percentile(pct); }
+#endif
 
  protected:
   /// @brief Tag for logging
@@ -118,70 +421,198 @@ class RGBStatusLED : public light::LightOutput, public Component {
   output::FloatOutput *green_output_{nullptr};
   output::FloatOutput *blue_output_{nullptr};
 
-  /**
-   * @brief RGB color structure
-   * 
-   * Stores RGB values as floats (0.0 to 1.0) for consistency
-   * with ESPHome's color system.
-   */
-  struct RGBColor {
-    float r, g, b;
-    RGBColor(float red = 0, float green = 0, float blue = 0) : r(red), g(green), b(blue) {}
-  };
-  
-  // Event configurations with ESPHome-compatible defaults
-  EventConfig error_config_{true, {1.0f, 0.0f, 0.0f}, 1.0f, "blink"};        ///< Red fast blink
-  EventConfig warning_config_{true, {1.0f, 0.5f, 0.0f}, 1.0f, "blink"};      ///< Orange slow blink
-  EventConfig ok_config_{true, {0.0f, 1.0f, 0.1f}, 1.0f, "none"};           ///< Green solid
-  EventConfig boot_config_{true, {1.0f, 0.0f, 0.0f}, 1.0f, "none"};          ///< Red solid
-  EventConfig wifi_connected_config_{true, {0.7f, 0.7f, 0.7f}, 1.0f, "none"}; ///< White solid
-  EventConfig api_connected_config_{true, {0.0f, 1.0f, 0.1f}, 1.0f, "none"};   ///< Green solid
-  EventConfig api_disconnected_config_{true, {1.0f, 1.0f, 0.0f}, 1.0f, "none"}; ///< Yellow solid
-  EventConfig ota_begin_config_{true, {0.0f, 0.0f, 1.0f}, 1.0f, "none"};      ///< Blue solid
-  EventConfig ota_progress_config_{true, {0.0f, 0.0f, 1.0f}, 1.0f, "blink"};   ///< Blue blink
-  EventConfig ota_end_config_{true, {0.0f, 1.0f, 0.1f}, 1.0f, "none"};        ///< Green solid
-  EventConfig ota_error_config_{true, {1.0f, 0.0f, 0.0f}, 1.0f, "blink"};      ///< Red fast blink
-
-  // Timing configuration - matches ESPHome internal status_led exactly
-  uint32_t error_blink_speed_{250};     ///< Error blink period in milliseconds (matches ESPHome)
-  uint32_t warning_blink_speed_{1500};  ///< Warning blink period in milliseconds (matches ESPHome)
+  // Event configurations indexed by StatusState. Points at a constant table in flash (generated by
+  // codegen, or DEFAULT_EVENT_TABLE); runtime config setters switch it to a copy on first use.
+  const PackedEventConfig *states_{DEFAULT_EVENT_TABLE};
+  PackedEventConfig *owned_states_{nullptr};  ///< Writable copy of the table, only allocated by runtime setters
+#ifdef RGB_STATUS_LED_USE_CODE
+  // Blink codes set at runtime; error codes change often, so they do not copy the table
+  uint8_t blink_codes_[STATUS_STATE_COUNT]{};  ///< Runtime code per StatusState
+  uint16_t code_overrides_{0};                 ///< States whose code comes from blink_codes_, one bit per StatusState
+#endif
+
   float brightness_{0.5f};               ///< Global brightness multiplier (0.0 to 1.0)
 
   // Priority and behavior configuration
   PriorityMode priority_mode_{PriorityMode::STATUS_PRIORITY};
-  bool ok_state_enabled_{true};  ///< Whether to show OK state or turn LED off
+
+  // Event-driven scheduling
+  static const uint32_t NO_DEADLINE = 0xFFFFFFFF;  ///< Output will not change on its own
+  bool event_driven_{false};               ///< Disable loop() between output changes
+  uint32_t app_state_poll_interval_{100};  ///< Max sleep while idle, app state has no change callback
+  uint32_t effect_delay_{NO_DEADLINE};     ///< Milliseconds until the current effect changes output (0 = every loop)
 
   // State management
   StatusState current_state_{StatusState::BOOT};  ///< Currently displayed state
   StatusState last_state_{StatusState::NONE};      ///< Previously displayed state
   bool user_control_active_{false};                 ///< Whether user is controlling the LED
   bool first_loop_{true};                           ///< First loop iteration flag
+  bool in_update_{false};                           ///< update_state_() is running (re-entrancy guard)
+  uint8_t immediate_renders_{0};                    ///< Setter-triggered renders since the last loop()
+  uint8_t batch_depth_{0};                          ///< Composite setters running, they render once at the end
   uint32_t last_state_change_{0};                   ///< Timestamp of last state change
-  uint32_t boot_complete_time_{0};                   ///< Timestamp when boot phase completes
   
-  // Connection state tracking (set via automation callbacks)
-  bool wifi_connected_{false};        ///< WiFi connection status
-  bool api_connected_{false};         ///< Home Assistant API connection status
-  bool ota_active_{false};            ///< OTA operation in progress
-  uint32_t ota_progress_time_{0};     ///< Last OTA progress update timestamp
+  // Active status conditions, one bit per StatusState (bit index = priority).
+  // Only updated when an input changes; NONE is always set so resolution never sees an empty mask.
+  uint32_t active_conditions_{0};
+  uint32_t enabled_conditions_{ENABLED_EVENTS | 1u};  ///< Conditions whose event is enabled (NONE always is)
+  uint32_t last_app_state_{0};  ///< App error/warning bits seen on the previous tick
+  MpscQueue<StatusEvent, STATUS_EVENT_QUEUE_SIZE> events_;  ///< Status inputs from other tasks
+
+  // Status source registry, ordered by rank so the highest set bit is the highest ranked active source
+  friend class StatusSource;
+  std::vector<StatusSource *> sources_;          ///< Registered sources, index = slot
+  uint32_t active_sources_{0};                   ///< Raised and enabled sources, one bit per slot
+  const StatusSource *current_source_{nullptr};  ///< Displayed source (nullptr = built-in state)
+#ifdef USE_WIFI
+  bool wifi_seen_{false};       ///< WiFi connection state seen on the previous tick
+#endif
+#ifdef USE_API
+  bool api_seen_{false};        ///< API connection state seen on the previous tick
+#endif
+
+  /// Table entry for a state
+  const PackedEventConfig &state_config_(StatusState state) const { return this->states_[static_cast<uint8_t>(state)]; }
+  PackedEventConfig &mutable_state_config_(StatusState state);  ///< Writable table entry, copies the table on first use
+#ifdef RGB_STATUS_LED_USE_CODE
+  uint8_t blink_code_(StatusState state) const;                  ///< Runtime code if set, else the table's
+#endif
+
+  // Render plan for the displayed state
+  RenderPlan plan_;         ///< Levels and timing for the displayed state
+  bool plan_dirty_{true};   ///< Plan must be rebuilt before the next render
 
   // Core logic methods
-  void update_state_();                                           ///< Main state update logic
-  void set_rgb_output_(const RGBColor &color, float brightness_scale = 1.0f);  ///< Set RGB output with color
-  void set_rgb_output_(float r, float g, float b, float brightness_scale = 1.0f); ///< Set RGB output with components
-  StatusState determine_status_state_();                           ///< Determine current status based on all inputs
-  void apply_state_(StatusState state);                           ///< Apply visual effects for a state
-  bool should_show_status_();                                     ///< Check if status should override user control
-  void apply_effect_(const EventConfig &config);                   ///< Apply effect based on configuration
+  void update_state_(uint32_t now);                               ///< Main state update logic
+  void write_levels_(uint32_t now, const uint16_t levels[3]);     ///< Write 16-bit levels to the RGB outputs
+  void write_channel_(uint8_t channel, output::FloatOutput *output, uint16_t level); ///< Write one channel if its level changed
+#ifdef RGB_STATUS_LED_DITHER
+  uint16_t dither_channel_(uint8_t channel, uint16_t level);      ///< Output step for this dither frame
+#endif
+  StatusState determine_status_state_(uint32_t now);               ///< Determine current status based on all inputs
+  void set_condition_(StatusState state, bool active);            ///< Raise or clear a status condition
+  void set_source_(StatusSource *source, bool active);            ///< Raise or clear a registered source
+  const StatusSource *resolve_source_(StatusState state) const;   ///< Source ranked above a built-in state, if any
+  void input_changed_();                                          ///< Wake up and render after an input change
+  void render_now_();                                             ///< Resolve and render right away if the state changed
+  void begin_batch_() { this->batch_depth_++; }                   ///< Hold immediate renders while changing several conditions
+  void end_batch_();                                              ///< Render once the outermost batch ends
+  void set_ota_active_(bool active);                              ///< Start (solid, then blink) or end OTA indication
+  void drain_events_();                                           ///< Apply queued status events
+  void update_app_state_();                                       ///< Track app error/warning edges
+  void update_connection_state_();                                ///< Track WiFi/API connection edges
+#ifdef USE_OTA_STATE_CALLBACK
+  void on_ota_state_(ota::OTAState state, float progress);        ///< OTA state callback
+  bool ota_progress_posted_{false};  ///< Progress already queued for this update (producer side only)
+#endif
+  void build_plan_(StatusState state, const StatusSource *source);  ///< Precompute the render plan for a state or source
+  bool should_show_status_(uint32_t now);                         ///< Check if status should override user control
+  void apply_effect_(uint32_t now);                               ///< Render the current plan
+  uint32_t compute_next_update_delay_(uint32_t now);              ///< Milliseconds until output can next change
+  void schedule_next_update_(uint32_t now);                       ///< Arm wake-up timeout and disable loop()
+  void wake_();                                                   ///< Re-enable loop() after an input change
+  void invalidate_plan_();                                        ///< Rebuild the plan after a config change
   
   // Effect methods
-  void apply_none_effect_(const EventConfig &config);             ///< Solid color effect
-  void apply_blink_effect_(const EventConfig &config, uint32_t period, uint32_t on_time); ///< Blink effect
-  void apply_pulse_effect_(const EventConfig &config);            ///< Pulse effect
+  void apply_none_effect_(uint32_t now);  ///< Solid color effect
+#ifdef RGB_STATUS_LED_USE_BLINK
+  void apply_blink_effect_(uint32_t now); ///< Blink effect
+#endif
+#ifdef RGB_STATUS_LED_USE_PULSE
+  void apply_pulse_effect_(uint32_t now); ///< Pulse effect
+#endif
+#ifdef RGB_STATUS_LED_USE_TIMELINE
+  void apply_timeline_effect_(uint32_t now); ///< Keyframe timeline effect
+  
+  // Keyframe timeline playback, the cursor caches the current keyframe
+  static const uint8_t KEYFRAME_RESTART = 0xFF;       ///< Cursor restarts on the next render
+  const Timeline *timelines_{nullptr};                ///< Timelines indexed by StatusState
+  uint8_t keyframe_index_{KEYFRAME_RESTART};          ///< Current keyframe
+  uint32_t keyframe_start_{0};                        ///< Time the current keyframe started
+  uint32_t keyframe_rate_{0};                         ///< 2^32 / duration of the current keyframe
+#endif
+#ifdef RGB_STATUS_LED_USE_CODE
+  void apply_code_effect_(uint32_t now);  ///< Blink code effect
+#endif
+#ifdef RGB_STATUS_LED_USE_PATTERN
+  void apply_pattern_effect_(uint32_t now); ///< Bytecode pattern effect
+  
+  const Pattern *patterns_{nullptr};  ///< Pattern programs indexed by StatusState
+  PatternVM pattern_vm_;              ///< Interpreter running the displayed state's program
+  bool pattern_restart_{true};        ///< Restart the program on the next render
+#endif
+  
+#ifdef RGB_STATUS_LED_TRANSITION
+  // Crossfade between states (levels in 16.16 fixed point)
+  uint32_t transition_length_{0};          ///< Crossfade duration in milliseconds
+  uint32_t fade_frame_interval_{20};       ///< Minimum milliseconds between fade frames
+  uint16_t emitted_level_[3]{0, 0, 0};     ///< Linear levels last passed to the outputs
+  uint32_t fade_level_[3]{0, 0, 0};        ///< Current fade level per channel
+  int32_t fade_step_[3]{0, 0, 0};          ///< Per-frame increment per channel, precomputed at fade start
+  uint32_t fade_frames_left_{0};           ///< Remaining fade frames (0 = not fading)
+  uint32_t fade_last_frame_{0};            ///< Timestamp of the last fade frame
+  void start_fade_(uint32_t now);          ///< Begin a crossfade to the current plan
+  void apply_fade_(uint32_t now);          ///< Render one fade frame if it is due
+  void handover_levels_(uint32_t at, uint16_t levels[3]);  ///< First levels the plan's effect shows at `at`
+#endif
   
   // Blink effect management
   bool is_blink_on_{false};            ///< Current blink state (on/off)
   uint32_t last_blink_toggle_{0};      ///< Timestamp of last blink toggle
+
+  // Output write cache (levels quantized to 16 bits, indexed R/G/B)
+  static const uint32_t LEVEL_UNKNOWN = 0xFFFFFFFF;  ///< Channel has not been written yet
+  uint32_t last_level_[3]{LEVEL_UNKNOWN, LEVEL_UNKNOWN, LEVEL_UNKNOWN};  ///< Last level written per channel
+  uint32_t output_writes_{0};             ///< Number of set_level() calls issued
+  uint32_t output_writes_suppressed_{0};  ///< Number of writes skipped because the level was unchanged
+#ifdef RGB_STATUS_LED_CORRECTION
+  const uint16_t *correction_table_{nullptr};  ///< Linear to corrected level table in flash, nullptr = uncorrected
+#endif
+#ifdef RGB_STATUS_LED_DITHER
+  static const uint32_t DITHER_FRAME_INTERVAL = 16;  ///< Milliseconds per dither frame, ESPHome's loop interval
+  static const uint16_t DITHER_MIN_REMAINDER = 256;  ///< Remainders closer to a step than this are held still
+  uint8_t dither_bits_{0};              ///< Resolution of the outputs being dithered to (8-15 bits, 0 = off)
+  uint32_t dither_frame_{0};            ///< Start of the current dither frame
+  bool dither_advance_{false};          ///< This write starts a new dither frame
+  bool dither_active_{false};           ///< A written level falls between output steps and needs frames
+  uint16_t dither_error_[3]{0x8000, 0x8000, 0x8000};  ///< Remainder carried into the current frame, per channel
+  uint16_t dither_next_[3]{0x8000, 0x8000, 0x8000};   ///< Remainder left by the current frame's last write
+#endif
+
+#ifdef RGB_STATUS_LED_LOOP_STATS
+  /// Loop cost accumulated for one displayed state over a reporting interval
+  struct LoopStats {
+    uint32_t calls{0};     ///< loop() calls rendering this state
+    uint32_t total_us{0};  ///< Total time spent in those calls
+    uint32_t max_us{0};    ///< Slowest single call
+    uint32_t writes{0};    ///< set_level() calls issued
+  };
+  static const uint32_t LOOP_STATS_INTERVAL = 60000;  ///< Reporting interval in milliseconds
+  LoopStats loop_stats_[STATUS_STATE_COUNT];            ///< Per-state loop cost, indexed by StatusState
+  uint32_t loop_budget_us_{0};                          ///< Warn when average loop cost exceeds this (0 = off)
+  void record_loop_stats_(uint32_t elapsed_us, uint32_t writes);  ///< Account one loop() call
+  void log_loop_stats_();                               ///< Report and reset the per-state statistics
+#endif
+
+#ifdef RGB_STATUS_LED_LATENCY
+  /// Event to light latencies in power-of-two microsecond buckets (bucket i holds 2^i..2^(i+1)-1 us)
+  static const uint8_t LATENCY_BUCKETS = 24;  ///< Last bucket collects everything from 8.4s up
+  struct LatencyHistogram {
+    uint32_t buckets[LATENCY_BUCKETS]{};
+    uint32_t count{0};
+    void record(uint32_t us);
+    uint32_t percentile(uint8_t pct) const;  ///< Upper bound in microseconds of the pct-th percentile
+  };
+  LatencyHistogram latency_;         ///< Since boot
+  bool latency_pending_{false};      ///< An input changed and its state has not been rendered yet
+  uint32_t latency_start_us_{0};     ///< micros() of the earliest unrendered input change
+  uint32_t last_poll_us_{0};         ///< micros() of the previous app state and connection poll
+  void mark_input_(uint32_t at_us);  ///< Start timing an input change
+#ifdef USE_SENSOR
+  static const uint32_t LATENCY_REPORT_INTERVAL = 60000;  ///< Sensor publish interval in milliseconds
+  sensor::Sensor *latency_sensor_{nullptr};
+#endif
+#endif
 };
 
 }  // namespace rgb_status_led
@@ -0,0 +1,293 @@
+// Loop cost per displayed state and effect
+//
+// Drives RGBStatusLED::loop() on the virtual clock through every state/effect combination and
+// reports, per scenario:
+//   - ns per loop() call (fastest of many interleaved runs, wall clock on this machine)
+//   - the median over those runs of the cost relative to a fixed integer calibration workload
+//     timed right before each run, which is what the baseline stores so it carries over between
+//     machines and load changes
+//   - set_level() calls per second of virtual time at ESPHome's 16ms loop interval
+//   - float operations per tick: steady-state rendering is integer-only, the one float divide
+//     left is the 16-bit to 0.0-1.0 conversion in front of every set_level() call
+//
+// With --baseline FILE the run fails when a scenario's relative cost grows by more than the
+// threshold (--threshold, default 0.5 = +50%) or it issues more output writes than recorded. A
+// cost regression is measured again up to ATTEMPTS times first, a busy machine only slows runs down.
+// --update rewrites the baseline from this run. Costs are only compared in optimized builds (the
+// default RelWithDebInfo the baseline was recorded with); write counts are always compared.
+
+#include "host.h"
+#include "esphome/core/application.h"
+#include "rgb_status_led/rgb_status_led.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+const uint32_t TICK_MS = 16;            ///< ESPHome's default loop interval
+const uint32_t TICKS = 20000;           ///< Ticks per measured run (320s of virtual time)
+const uint32_t REPEATS = 31;            ///< Runs per scenario, interleaved; the median ratio counts
+const uint32_t CALIBRATION_OPS = 64;    ///< Work per calibration "call"
+const uint32_t ATTEMPTS = 3;            ///< Measurements before a cost regression is reported
+const uint32_t ATTEMPT_PAUSE_MS = 500;  ///< Pause before measuring again
+
+const Keyframe BENCH_KEYFRAMES[2] = {{500, 255, 0, 0, Keyframe::LINEAR}, {500, 0, 0, 255, Keyframe::LINEAR}};
+// color red, wait 200, color off, wait 300
+const uint8_t BENCH_PATTERN_CODE[] = {PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 200, 0,
+                                      PATTERN_OP_COLOR, 0,   0, 0, PATTERN_OP_WAIT, 44,  1};
+
+struct Scenario {
+  const char *name;
+  void (*configure)(RGBStatusLED &led);
+};
+
+const Scenario SCENARIOS[] = {
+    {"none", [](RGBStatusLED &led) { led.set_ok_state_enabled(false); }},
+    {"ok_solid", [](RGBStatusLED &led) {}},
+    {"user", [](RGBStatusLED &led) { led.set_priority_mode("user"); }},
+    {"error_blink", [](RGBStatusLED &led) { App.set_app_state(STATUS_LED_ERROR); }},
+    {"warning_blink", [](RGBStatusLED &led) { App.set_app_state(STATUS_LED_WARNING); }},
+    {"pulse",
+     [](RGBStatusLED &led) { led.set_ok_config(EventConfig(true, {0.0f, 1.0f, 0.1f}, 1.0f, EffectType::PULSE)); }},
+    {"code",
+     [](RGBStatusLED &led) {
+       led.set_error_config(EventConfig(true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::CODE));
+       led.set_error_code(3);
+       App.set_app_state(STATUS_LED_ERROR);
+     }},
+    {"timeline",
+     [](RGBStatusLED &led) {
+       static Timeline timelines[STATUS_STATE_COUNT]{};
+       timelines[static_cast<uint8_t>(StatusState::OK)] = {BENCH_KEYFRAMES, 2, 1000};
+       led.set_timeline_table(timelines);
+       led.set_ok_config(EventConfig(true, {1.0f, 1.0f, 1.0f}, 1.0f, EffectType::TIMELINE));
+     }},
+    {"pattern",
+     [](RGBStatusLED &led) {
+       static Pattern patterns[STATUS_STATE_COUNT]{};
+       patterns[static_cast<uint8_t>(StatusState::OK)] = {BENCH_PATTERN_CODE, sizeof(BENCH_PATTERN_CODE)};
+       led.set_pattern_table(patterns);
+       led.set_ok_config(EventConfig(true, {1.0f, 1.0f, 1.0f}, 1.0f, EffectType::PATTERN));
+     }},
+};
+
+struct Result {
+  double ns_per_call{1e18};     ///< Fastest run, clock steps subtracted
+  double calibration_ns{1e18};  ///< Calibration timed right before the run
+  double relative{1e18};        ///< Median ratio of the two within one run
+  uint32_t writes{0};           ///< set_level() calls per run
+  std::vector<double> ratios;   ///< Per-run ratios of the current round
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ns(Clock::time_point start) {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+/// ns for CALIBRATION_OPS rounds of xorshift, a fixed integer workload to normalize against
+double calibrate() {
+  volatile uint32_t sink = 0;
+  uint32_t x = 2463534242u;
+  Clock::time_point start = Clock::now();
+  for (uint32_t tick = 0; tick < TICKS; tick++) {
+    for (uint32_t i = 0; i < CALIBRATION_OPS; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+    }
+    sink = sink + x;
+  }
+  return elapsed_ns(start) / TICKS;
+}
+
+/// One timed run of the clock steps with and without loop(), plus the output writes
+Result measure(const Scenario &scenario) {
+  host::reset();
+  output::FloatOutput red, green, blue;
+  RGBStatusLED led;
+  led.set_red_output(&red);
+  led.set_green_output(&green);
+  led.set_blue_output(&blue);
+  led.setup();
+  led.loop();
+  host::run(&led, 10000 + TICK_MS, TICK_MS);  // Past the boot window
+  scenario.configure(led);
+  host::run(&led, 10 * TICK_MS, TICK_MS);  // Settle into the state
+
+  // Calibration and the same number of clock steps without loop(), under the same load as the run
+  Result result;
+  result.calibration_ns = calibrate();
+  Clock::time_point start = Clock::now();
+  for (uint32_t tick = 0; tick < TICKS; tick++) {
+    host::advance(TICK_MS);
+  }
+  double clock_ns = elapsed_ns(start);
+
+  uint32_t writes = red.writes + green.writes + blue.writes;
+  start = Clock::now();
+  for (uint32_t tick = 0; tick < TICKS; tick++) {
+    host::advance(TICK_MS);
+    led.loop();
+  }
+  result.ns_per_call = std::max(elapsed_ns(start) - clock_ns, 0.0) / TICKS;
+  result.relative = result.ns_per_call / result.calibration_ns;
+  result.writes = red.writes + green.writes + blue.writes - writes;
+  return result;
+}
+
+using Results = std::vector<std::pair<const char *, Result>>;
+
+/// One more round of interleaved runs, keeping the best of each figure seen so far
+void measure_all(Results &results) {
+  // Repeats interleaved across scenarios, so a noisy moment does not hit one scenario's every run
+  for (uint32_t repeat = 0; repeat < REPEATS; repeat++) {
+    for (size_t i = 0; i < results.size(); i++) {
+      Result run = measure(SCENARIOS[i]);
+      Result &best = results[i].second;
+      best.ns_per_call = std::min(best.ns_per_call, run.ns_per_call);
+      best.calibration_ns = std::min(best.calibration_ns, run.calibration_ns);
+      best.ratios.push_back(run.relative);
+      best.writes = run.writes;  // Deterministic
+    }
+  }
+  // Median of the round, the fastest single run is as much luck as the slowest
+  for (auto &entry : results) {
+    Result &result = entry.second;
+    std::nth_element(result.ratios.begin(), result.ratios.begin() + REPEATS / 2, result.ratios.end());
+    result.relative = std::min(result.relative, result.ratios[REPEATS / 2]);
+    result.ratios.clear();
+  }
+}
+
+/// Whether a scenario costs more than the threshold allows; only optimized builds are compared
+bool over_cost(const Result &result, const Result &baseline, double threshold) {
+#ifdef NDEBUG
+  return result.relative > baseline.relative * (1.0 + threshold);
+#else
+  return false;
+#endif
+}
+
+std::map<std::string, Result> read_baseline(const char *path) {
+  std::map<std::string, Result> baseline;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    Result entry;
+    if (fields >> name >> entry.relative >> entry.writes) {
+      baseline[name] = entry;
+    }
+  }
+  return baseline;
+}
+
+void write_baseline(const char *path, const Results &results) {
+  std::ofstream file(path);
+  file << "# Loop cost baseline for bench_loop: scenario, cost relative to the calibration workload,\n"
+       << "# set_level() calls per " << TICKS << " ticks. Regenerate with: bench_loop --baseline <this file> --update\n";
+  for (const auto &entry : results) {
+    char relative[32];
+    std::snprintf(relative, sizeof(relative), "%.4f", entry.second.relative);
+    file << entry.first << " " << relative << " " << entry.second.writes << "\n";
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *baseline_path = nullptr;
+  bool update = false;
+  double threshold = 0.5;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+      threshold = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--update") == 0) {
+      update = true;
+    } else {
+      std::printf("usage: %s [--baseline FILE [--update]] [--threshold FRACTION]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Results results;
+  for (const Scenario &scenario : SCENARIOS) {
+    results.emplace_back(scenario.name, Result());
+  }
+  measure_all(results);
+
+  std::map<std::string, Result> baseline;
+  if (baseline_path != nullptr && !update) {
+    baseline = read_baseline(baseline_path);
+    for (uint32_t attempt = 1; attempt < ATTEMPTS; attempt++) {
+      bool slower = false;
+      for (const auto &entry : results) {
+        auto it = baseline.find(entry.first);
+        slower |= it != baseline.end() && over_cost(entry.second, it->second, threshold);
+      }
+      if (!slower) {
+        break;
+      }
+      std::printf("cost over the baseline, measuring again (%u of %u)\n", attempt + 1, ATTEMPTS);
+      std::this_thread::sleep_for(std::chrono::milliseconds(ATTEMPT_PAUSE_MS));  // Let a burst of load pass
+      measure_all(results);
+    }
+  }
+
+  std::printf("%-14s %10s %14s %9s %13s %15s\n", "scenario", "ns/call", "calibration ns", "relative",
+              "set_level/s", "float ops/tick");
+  for (const auto &entry : results) {
+    const Result &result = entry.second;
+    double seconds = TICKS * TICK_MS / 1000.0;
+    std::printf("%-14s %10.1f %14.1f %9.4f %13.1f %15.3f\n", entry.first, result.ns_per_call, result.calibration_ns,
+                result.relative, result.writes / seconds, static_cast<double>(result.writes) / TICKS);
+  }
+
+  if (baseline_path == nullptr) {
+    return 0;
+  }
+  if (update) {
+    write_baseline(baseline_path, results);
+    std::printf("\nbaseline written to %s\n", baseline_path);
+    return 0;
+  }
+
+  int regressions = 0;
+  for (const auto &entry : results) {
+    auto it = baseline.find(entry.first);
+    if (it == baseline.end()) {
+      std::printf("%s: no baseline, run with --update\n", entry.first);
+      regressions++;
+      continue;
+    }
+    if (over_cost(entry.second, it->second, threshold)) {
+      std::printf("%s: cost %.4f exceeds baseline %.4f by more than %.0f%%\n", entry.first, entry.second.relative,
+                  it->second.relative, threshold * 100.0);
+      regressions++;
+    }
+    if (entry.second.writes > it->second.writes) {
+      std::printf("%s: %u set_level() calls, baseline %u\n", entry.first, entry.second.writes, it->second.writes);
+      regressions++;
+    }
+  }
+  std::printf("\n%s\n", regressions == 0 ? "no regressions against the baseline" : "REGRESSIONS against the baseline");
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "host.h"
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+#include <cstdarg>
+#include <vector>
+
+namespace esphome {
+
+Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+namespace host {
+
+int failures = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+namespace {
+
+struct Timer {
+  Component *owner;
+  std::string name;
+  uint64_t due_us;
+  uint32_t interval_ms;  ///< 0 = one-shot timeout
+  std::function<void()> callback;
+};
+
+uint64_t clock_us = 0;       // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+bool verbose = false;        // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::vector<Timer> timers;   // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void remove_timer(Component *owner, const std::string &name) {
+  timers.erase(std::remove_if(timers.begin(), timers.end(),
+                              [&](const Timer &timer) { return timer.owner == owner && timer.name == name; }),
+               timers.end());
+}
+
+}  // namespace
+
+void reset() {
+  clock_us = 0;
+  timers.clear();
+  App.set_app_state(0);
+}
+
+void set_verbose(bool enabled) { verbose = enabled; }
+
+uint64_t now_us() { return clock_us; }
+
+void advance_us(uint64_t us) {
+  const uint64_t target = clock_us + us;
+  for (;;) {
+    // Earliest due timer within the step; callbacks may add or cancel timers
+    auto next = std::min_element(timers.begin(), timers.end(),
+                                 [](const Timer &a, const Timer &b) { return a.due_us < b.due_us; });
+    if (next == timers.end() || next->due_us > target) {
+      break;
+    }
+    clock_us = std::max(clock_us, next->due_us);
+    std::function<void()> callback = next->callback;
+    if (next->interval_ms != 0) {
+      next->due_us += static_cast<uint64_t>(next->interval_ms) * 1000;
+    } else {
+      timers.erase(next);
+    }
+    callback();
+  }
+  clock_us = target;
+}
+
+uint32_t run(Component *component, uint32_t ms, uint32_t step) {
+  uint32_t loops = 0;
+  for (uint32_t elapsed = 0; elapsed < ms; elapsed += step) {
+    advance(step);
+    if (component->is_loop_enabled()) {
+      component->loop();
+      loops++;
+    }
+  }
+  return loops;
+}
+
+void log(char level, const char *tag, const char *format, ...) {
+  if (!verbose) {
+    return;
+  }
+  std::printf("[%c][%s] ", level, tag);
+  va_list args;
+  va_start(args, format);
+  std::vprintf(format, args);
+  va_end(args);
+  std::printf("\n");
+}
+
+}  // namespace host
+
+uint32_t millis() { return static_cast<uint32_t>(host::clock_us / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(host::clock_us); }
+
+Component::~Component() {
+  host::timers.erase(std::remove_if(host::timers.begin(), host::timers.end(),
+                                    [this](const host::Timer &timer) { return timer.owner == this; }),
+                     host::timers.end());
+}
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  host::remove_timer(this, name);
+  host::timers.push_back({this, name, host::clock_us + static_cast<uint64_t>(timeout) * 1000, 0, std::move(f)});
+}
+
+bool Component::cancel_timeout(const std::string &name) {
+  size_t before = host::timers.size();
+  host::remove_timer(this, name);
+  return host::timers.size() != before;
+}
+
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  host::remove_timer(this, name);
+  host::timers.push_back(
+      {this, name, host::clock_us + static_cast<uint64_t>(interval) * 1000, interval, std::move(f)});
+}
+
+}  // namespace esphome
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host test harness: virtual clock, scheduler and a minimal check framework.
+//
+// The component is compiled unchanged against the stand-ins in stubs/. Time only
+// moves when a test advances it, so every run is deterministic.
+
+#include <cstdint>
+#include <cstdio>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace host {
+
+void reset();                     ///< Clock back to 0, pending timers dropped
+void set_verbose(bool verbose);  ///< Print log output
+uint64_t now_us();
+
+/// Move the clock forward and fire the timeouts and intervals that became due
+void advance_us(uint64_t us);
+inline void advance(uint32_t ms) { advance_us(static_cast<uint64_t>(ms) * 1000); }
+
+/// Advance `ms` in `step` increments, calling component->loop() after each step while its loop is enabled
+uint32_t run(Component *component, uint32_t ms, uint32_t step = 1);
+
+// Checks: count failures and report them, tests return host::result() from main()
+extern int failures;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+inline int result() {
+  if (failures != 0) {
+    std::printf("%d check(s) failed\n", failures);
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+}  // namespace host
+}  // namespace esphome
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      esphome::host::failures++; \
+    } \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+  do { \
+    double check_a_ = (a), check_b_ = (b); \
+    if (check_a_ - check_b_ > (tolerance) || check_b_ - check_a_ > (tolerance)) { \
+      std::printf("%s:%d: check failed: %s = %g, %s = %g (tolerance %g)\n", __FILE__, __LINE__, #a, check_a_, #b, \
+                  check_b_, static_cast<double>(tolerance)); \
+      esphome::host::failures++; \
+    } \
+  } while (0)
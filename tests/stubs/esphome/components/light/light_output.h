@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the light output interface
+
+#include <initializer_list>
+
+namespace esphome {
+namespace light {
+
+enum class ColorMode { RGB };
+
+class LightTraits {
+ public:
+  void set_supported_color_modes(std::initializer_list<ColorMode> modes) {}
+};
+
+class LightCall {
+ public:
+  void perform() {}
+};
+
+class LightState {
+ public:
+  LightCall turn_on() { return {}; }
+};
+
+class LightOutput {
+ public:
+  virtual ~LightOutput() = default;
+  virtual LightTraits get_traits() = 0;
+  virtual void write_state(LightState *state) = 0;
+};
+
+}  // namespace light
+}  // namespace esphome
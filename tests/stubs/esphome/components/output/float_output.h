@@ -0,0 +1,22 @@
+#pragma once
+
+// Host stand-in: records the last level and counts writes
+
+#include <cstdint>
+
+namespace esphome {
+namespace output {
+
+class FloatOutput {
+ public:
+  void set_level(float state) {
+    this->level = state;
+    this->writes++;
+  }
+
+  float level{-1.0f};  ///< Last written level (-1 = never written)
+  uint32_t writes{0};
+};
+
+}  // namespace output
+}  // namespace esphome
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in: the application state is set directly by tests
+
+#include <cstdint>
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+class Application {
+ public:
+  uint32_t get_app_state() const { return this->app_state_; }
+  void set_app_state(uint32_t state) { this->app_state_ = state; }  ///< Host only
+
+ protected:
+  uint32_t app_state_{0};
+};
+
+extern Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace esphome
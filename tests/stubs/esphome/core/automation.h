@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in: actions are played directly, without triggers or automations
+
+namespace esphome {
+
+template<typename... Ts> class Action {
+ public:
+  virtual ~Action() = default;
+  virtual void play(Ts... x) = 0;
+};
+
+}  // namespace esphome
@@ -0,0 +1,43 @@
+#pragma once
+
+// Host stand-in for the ESPHome component base. Timeouts and intervals run on the
+// virtual clock and fire from host::advance().
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+const float HARDWARE = 800.0f;
+}  // namespace setup_priority
+
+const uint32_t STATUS_LED_MASK = 0x18;
+const uint32_t STATUS_LED_OK = 0x00;
+const uint32_t STATUS_LED_WARNING = 0x08;
+const uint32_t STATUS_LED_ERROR = 0x10;
+
+class Component {
+ public:
+  virtual ~Component();
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+  virtual float get_loop_priority() const { return 0.0f; }
+
+  void enable_loop() { this->loop_enabled_ = true; }
+  void disable_loop() { this->loop_enabled_ = false; }
+  void enable_loop_soon_any_context() { this->loop_enabled_ = true; }
+  bool is_loop_enabled() const { return this->loop_enabled_; }  ///< Host only
+
+ protected:
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+
+  bool loop_enabled_{true};
+};
+
+}  // namespace esphome
@@ -0,0 +1,3 @@
+#pragma once
+
+// Host stand-in: feature defines are passed per test target by CMake
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in: time comes from the virtual clock in host.h
+
+#include <cstdint>
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+
+}  // namespace esphome
@@ -0,0 +1,18 @@
+#pragma once
+
+// Host stand-in: log calls are format-checked and printed when host::set_verbose(true)
+
+namespace esphome {
+namespace host {
+
+void log(char level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+}  // namespace host
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) esphome::host::log('E', tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) esphome::host::log('W', tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) esphome::host::log('I', tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) esphome::host::log('C', tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) esphome::host::log('D', tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) esphome::host::log('V', tag, __VA_ARGS__)
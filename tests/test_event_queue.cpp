@@ -0,0 +1,105 @@
+// Status event queue: ordering, overflow and concurrent producers
+
+#include "host.h"
+#include "rgb_status_led/event_queue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+struct Item {
+  uint32_t producer{0};
+  uint32_t sequence{0};
+
+  Item() = default;
+  Item(uint32_t producer, uint32_t sequence) : producer(producer), sequence(sequence) {}
+  Item(const Item &other) = default;
+  /// Gives up the CPU halfway through, so producers interleave inside push() even on one core
+  Item &operator=(const Item &other) {
+    this->producer = other.producer;
+    std::this_thread::yield();
+    this->sequence = other.sequence;
+    return *this;
+  }
+};
+
+const uint32_t PRODUCERS = 4;
+const uint32_t ITEMS_PER_PRODUCER = 50000;
+
+void test_order_and_overflow() {
+  MpscQueue<Item, 16> queue;
+  Item item;
+  CHECK(!queue.pop(item));
+
+  // Several laps around the ring
+  for (uint32_t lap = 0; lap < 5; lap++) {
+    for (uint32_t i = 0; i < 16; i++) {
+      CHECK(queue.push({0, lap * 16 + i}));
+    }
+    CHECK(!queue.push({0, 999}));
+    for (uint32_t i = 0; i < 16; i++) {
+      CHECK(queue.pop(item) && item.sequence == lap * 16 + i);
+    }
+    CHECK(!queue.pop(item));
+  }
+  CHECK(queue.overflows() == 5);
+}
+
+void test_concurrent_producers() {
+  // Producers retry on a full queue so nothing is dropped; the consumer checks that every item
+  // arrives exactly once and in order per producer
+  MpscQueue<Item, 16> queue;
+  std::atomic<uint32_t> finished{0};
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&queue, &finished, p]() {
+      for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        while (!queue.push({p, i})) {
+          std::this_thread::yield();
+        }
+      }
+      finished.fetch_add(1);
+    });
+  }
+
+  uint32_t next[PRODUCERS]{};
+  uint32_t received = 0;
+  bool ordered = true;
+  Item item;
+  while (received < PRODUCERS * ITEMS_PER_PRODUCER) {
+    bool done = finished.load() == PRODUCERS;
+    if (!queue.pop(item)) {
+      if (done) {
+        break;  // Everything was published already; a lost item would otherwise leave this waiting forever
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    // Keep draining on a mismatch, producers waiting on a full queue must get to finish
+    if (item.producer < PRODUCERS && item.sequence == next[item.producer]) {
+      next[item.producer]++;
+    } else {
+      ordered = false;
+    }
+    received++;
+  }
+  for (std::thread &producer : producers) {
+    producer.join();
+  }
+
+  CHECK(ordered);
+  CHECK(received == PRODUCERS * ITEMS_PER_PRODUCER);
+  CHECK(!queue.pop(item));
+}
+
+}  // namespace
+
+int main() {
+  test_order_and_overflow();
+  test_concurrent_producers();
+  return host::result();
+}
@@ -0,0 +1,72 @@
+// Packed event configs render the same levels as the original float path, within quantization
+
+#include "host.h"
+#include "rgb_status_led/rgb_status_led.h"
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+/// The former float renderer: channel * global * (override == 1.0 ? global : override)
+double float_level(float channel, float config_brightness, float global_brightness) {
+  double scale = config_brightness == 1.0f ? global_brightness : config_brightness;
+  return static_cast<double>(channel) * global_brightness * scale;
+}
+
+void test_layout() {
+  CHECK(sizeof(PackedEventConfig) <= 12);
+  PackedEventConfig packed(EventConfig(false, {1.0f, 0.5f, 0.0f}, 0.25f, EffectType::CODE), 1500, 250, 100, 7);
+  CHECK(!packed.enabled());
+  CHECK(packed.effect() == EffectType::CODE);
+  CHECK(packed.r == 255 && packed.g == 128 && packed.b == 0 && packed.brightness == 64);
+  CHECK(packed.period == 1500 && packed.on_time == 250 && packed.phase == 100 && packed.code == 7);
+  CHECK(PackedEventConfig::pack_unit(-0.5f) == 0 && PackedEventConfig::pack_unit(1.5f) == 255);
+}
+
+void test_solid_matches_float_path() {
+  const float channels[] = {0.0f, 0.02f, 0.1f, 0.33f, 0.5f, 0.7f, 0.999f, 1.0f};
+  const float config_brightness[] = {1.0f, 0.8f, 0.5f, 0.1f};
+  const float global_brightness[] = {1.0f, 0.5f, 0.25f, 0.05f};
+
+  // Color and override are each packed to 8 bits: half a step of error on each factor
+  const double tolerance = 1.0 / 255 + 1.0 / 65535;
+  double max_error = 0.0;
+  for (float global : global_brightness) {
+    for (float config : config_brightness) {
+      for (float channel : channels) {
+        host::reset();
+        output::FloatOutput red, green, blue;
+        RGBStatusLED led;
+        led.set_red_output(&red);
+        led.set_green_output(&green);
+        led.set_blue_output(&blue);
+        led.set_brightness(global);
+        led.set_ok_config(EventConfig(true, {channel, 1.0f - channel, channel / 2}, config));
+        led.setup();
+        led.loop();
+        host::run(&led, 10100);
+
+        const double expected[3] = {float_level(channel, config, global), float_level(1.0f - channel, config, global),
+                                    float_level(channel / 2, config, global)};
+        const float actual[3] = {red.level, green.level, blue.level};
+        for (uint8_t i = 0; i < 3; i++) {
+          CHECK_NEAR(actual[i], expected[i], tolerance);
+          double error = actual[i] > expected[i] ? actual[i] - expected[i] : expected[i] - actual[i];
+          if (error > max_error) {
+            max_error = error;
+          }
+        }
+      }
+    }
+  }
+  std::printf("packed vs float max error: %.2e (one 8-bit step = %.2e)\n", max_error, 1.0 / 255);
+}
+
+}  // namespace
+
+int main() {
+  test_layout();
+  test_solid_matches_float_path();
+  return host::result();
+}
@@ -0,0 +1,154 @@
+// Pattern bytecode interpreter: loops, branches and wait scheduling
+//
+// Programs are laid out the way compile_pattern() in __init__.py emits them.
+
+#include "host.h"
+#include "rgb_status_led/pattern.h"
+
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+const uint8_t COND = 3;  ///< Condition bit tested by the while/if programs
+const uint32_t COND_ACTIVE = 1u << COND;
+
+// repeat 3: {red, wait 10, off, wait 10}; wait 100
+const uint8_t REPEAT_CODE[] = {PATTERN_OP_REPEAT, 3,
+                               PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 10, 0,
+                               PATTERN_OP_COLOR, 0, 0, 0, PATTERN_OP_WAIT, 10, 0,
+                               PATTERN_OP_END_REPEAT, 2, 0,
+                               PATTERN_OP_WAIT, 100, 0};
+
+// repeat 2: {repeat 2: {red, wait 5, off, wait 5}; wait 20}
+const uint8_t NESTED_CODE[] = {PATTERN_OP_REPEAT, 2,
+                               PATTERN_OP_REPEAT, 2,
+                               PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 5, 0,
+                               PATTERN_OP_COLOR, 0, 0, 0, PATTERN_OP_WAIT, 5, 0,
+                               PATTERN_OP_END_REPEAT, 4, 0,
+                               PATTERN_OP_WAIT, 20, 0,
+                               PATTERN_OP_END_REPEAT, 2, 0};
+
+// while COND: {red, wait 10}; green, wait 10
+const uint8_t WHILE_CODE[] = {PATTERN_OP_JUMP_IF_INACTIVE, COND, 14, 0,
+                              PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 10, 0,
+                              PATTERN_OP_JUMP, 0, 0,
+                              PATTERN_OP_COLOR, 0, 255, 0, PATTERN_OP_WAIT, 10, 0};
+
+// if COND: {red, wait 10} else: {blue, wait 10}
+const uint8_t IF_CODE[] = {PATTERN_OP_JUMP_IF_INACTIVE, COND, 14, 0,
+                           PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 10, 0,
+                           PATTERN_OP_JUMP, 21, 0,
+                           PATTERN_OP_COLOR, 0, 0, 255, PATTERN_OP_WAIT, 10, 0};
+
+// red, wait 10, off, wait 10
+const uint8_t BLINK_CODE[] = {PATTERN_OP_COLOR, 255, 0, 0, PATTERN_OP_WAIT, 10, 0,
+                              PATTERN_OP_COLOR, 0, 0, 0, PATTERN_OP_WAIT, 10, 0};
+
+/// Run the program one tick every `step` ms from 0 to `until`, counting off-to-red edges
+uint32_t count_flashes(PatternVM &vm, uint32_t from, uint32_t until, uint32_t conditions = 0, uint32_t step = 1) {
+  uint32_t flashes = 0;
+  bool lit = vm.color()[0] != 0;
+  for (uint32_t now = from; now < until; now += step) {
+    vm.run(now, conditions);
+    if (!lit && vm.color()[0] != 0) {
+      flashes++;
+    }
+    lit = vm.color()[0] != 0;
+  }
+  return flashes;
+}
+
+void test_repeat() {
+  const Pattern pattern{REPEAT_CODE, sizeof(REPEAT_CODE)};
+  PatternVM vm;
+  vm.reset(&pattern, 0);
+
+  // Lit for the first 10ms of each 20ms iteration, then dark for the 100ms tail
+  bool matched = true;
+  for (uint32_t now = 0; now < 320; now++) {
+    uint32_t offset = now % 160;
+    bool expected = offset < 60 && offset % 20 < 10;
+    vm.run(now, 0);
+    matched &= (vm.color()[0] != 0) == expected;
+  }
+  CHECK(matched);
+}
+
+void test_nested_repeat() {
+  const Pattern pattern{NESTED_CODE, sizeof(NESTED_CODE)};
+  PatternVM vm;
+  vm.reset(&pattern, 0);
+
+  // 2 x (2 flashes + 20ms pause) per 80ms cycle
+  CHECK(count_flashes(vm, 0, 80) == 4);
+  CHECK(count_flashes(vm, 80, 800) == 36);
+}
+
+void test_while() {
+  const Pattern pattern{WHILE_CODE, sizeof(WHILE_CODE)};
+  PatternVM vm;
+  vm.reset(&pattern, 0);
+
+  // Stays in the body while the condition holds
+  bool red = true;
+  for (uint32_t now = 0; now < 100; now++) {
+    vm.run(now, COND_ACTIVE);
+    red &= vm.color()[0] == 255 && vm.color()[1] == 0;
+  }
+  CHECK(red);
+
+  // Leaves once the current wait ends after it clears
+  CHECK(vm.run(95, 0) == 5);
+  CHECK(vm.color()[0] == 255);
+  vm.run(100, 0);
+  CHECK(vm.color()[0] == 0 && vm.color()[1] == 255);
+  vm.run(110, 0);
+  CHECK(vm.color()[1] == 255);  // Skips the body straight away while inactive
+  vm.run(120, COND_ACTIVE);
+  CHECK(vm.color()[0] == 255);
+}
+
+void test_if_else() {
+  const Pattern pattern{IF_CODE, sizeof(IF_CODE)};
+  PatternVM vm;
+  vm.reset(&pattern, 0);
+
+  vm.run(0, COND_ACTIVE);
+  CHECK(vm.color()[0] == 255 && vm.color()[2] == 0);
+  vm.run(10, 0);
+  CHECK(vm.color()[0] == 0 && vm.color()[2] == 255);
+  vm.run(15, COND_ACTIVE);
+  CHECK(vm.color()[2] == 255);  // Branch decided at the top of the program
+  vm.run(20, COND_ACTIVE);
+  CHECK(vm.color()[0] == 255);
+}
+
+void test_waits_do_not_drift() {
+  const Pattern pattern{BLINK_CODE, sizeof(BLINK_CODE)};
+  PatternVM vm;
+  vm.reset(&pattern, 0);
+
+  // Ticks every 7ms land late on most edges; the 20ms cycle still holds on average
+  CHECK_NEAR(count_flashes(vm, 0, 7000, 0, 7), 350, 1);
+
+  // The returned delay points at the scheduled edge, not at now + wait
+  vm.reset(&pattern, 0);
+  CHECK(vm.run(0, 0) == 10);
+  CHECK(vm.run(13, 0) == 7);  // Off since 13, next flash still at 20
+  CHECK(vm.run(20, 0) == 10);
+
+  // A stall longer than a whole wait restarts the schedule instead of replaying the backlog
+  CHECK(vm.run(1000, 0) == 10);
+  CHECK(vm.run(1010, 0) == 10);
+}
+
+}  // namespace
+
+int main() {
+  test_repeat();
+  test_nested_repeat();
+  test_while();
+  test_if_else();
+  test_waits_do_not_drift();
+  return esphome::host::result();
+}
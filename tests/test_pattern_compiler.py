@@ -0,0 +1,163 @@
+"""Pattern DSL validation and compilation, against stand-ins for the esphome package.
+
+Like the C++ tests, this needs no ESPHome install: validators from config_validation
+pass values through unchanged, so the steps are given in their validated form.
+"""
+
+import os
+import sys
+import types
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+
+class Invalid(Exception):
+    def __init__(self, message, path=None):
+        super().__init__(message)
+        self.path = path or []
+
+
+class Expression:
+    """Stand-in for codegen expressions: any attribute or call yields another one."""
+
+    def __getattr__(self, name):
+        return Expression()
+
+    def __call__(self, *args, **kwargs):
+        return Expression()
+
+
+class TimePeriod:
+    def __init__(self, milliseconds=0, microseconds=0):
+        self.total_milliseconds = milliseconds
+
+
+def passthrough(*args, **kwargs):
+    return lambda value: value
+
+
+def chain(*validators):
+    def validator(value):
+        for v in validators:
+            value = v(value)
+        return value
+    return validator
+
+
+def fake_module(name, **attrs):
+    module = types.ModuleType(name)
+    module.__getattr__ = lambda attr: passthrough
+    module.__dict__.update(attrs)
+    sys.modules[name] = module
+    parent, _, child = name.rpartition(".")
+    if parent:
+        setattr(sys.modules[parent], child, module)
+    return module
+
+
+schema = types.SimpleNamespace(extend=lambda *args: schema)
+fake_module("esphome")
+fake_module("esphome.codegen", esphome_ns=Expression(), Component=Expression())
+fake_module("esphome.automation", Action=Expression(), register_action=lambda *args: (lambda fn: fn))
+fake_module(
+    "esphome.config_validation", Invalid=Invalid, All=chain, Schema=passthrough, COMPONENT_SCHEMA=schema,
+    percentage=lambda value: value, positive_time_period_milliseconds=lambda value: value,
+)
+const = fake_module("esphome.const")
+const.__getattr__ = lambda attr: attr.replace("CONF_", "").lower()
+fake_module(
+    "esphome.core", TimePeriod=TimePeriod, CORE=types.SimpleNamespace(config={}), CoroPriority=Expression(),
+    coroutine_with_priority=lambda priority: (lambda fn: fn),
+)
+fake_module(
+    "esphome.components",
+    light=types.SimpleNamespace(LightOutput=Expression(), RGB_LIGHT_SCHEMA=schema),
+    output=types.SimpleNamespace(FloatOutput=Expression()),
+    sensor=types.SimpleNamespace(sensor_schema=passthrough),
+)
+
+import rgb_status_led as rsl  # noqa: E402
+
+failures = 0
+
+
+def check(condition, message):
+    global failures
+    if not condition:
+        print(f"check failed: {message}")
+        failures += 1
+
+
+def rejects(validator, value):
+    try:
+        validator(value)
+    except Invalid:
+        return True
+    return False
+
+
+RED = {"red": 1.0, "green": 0.0, "blue": 0.0}
+
+
+def wait(ms):
+    return {"wait": TimePeriod(milliseconds=ms)}
+
+
+def color(r, g, b):
+    return {"color": {"red": r, "green": g, "blue": b}}
+
+
+def test_compile():
+    code = rsl.compile_pattern([
+        {"repeat": {"count": 3, "then": [{"level": 1.0}, wait(200), {"level": 0.0}, wait(300)]}},
+        {"while": {"condition": "warning", "then": [color(0.0, 0.0, 1.0), wait(1000)]}},
+        {"if": {"condition": "ota_begin", "then": [wait(10)], "else": [wait(20)]}},
+    ], RED)
+    warning = rsl.EVENT_STATES["warning"]
+    ota = rsl.EVENT_STATES["ota_begin"]
+    expected = [
+        rsl.PATTERN_OP_REPEAT, 3,                                      # 0
+        rsl.PATTERN_OP_COLOR, 255, 0, 0, rsl.PATTERN_OP_WAIT, 200, 0,  # 2
+        rsl.PATTERN_OP_COLOR, 0, 0, 0, rsl.PATTERN_OP_WAIT, 44, 1,     # 9
+        rsl.PATTERN_OP_END_REPEAT, 2, 0,                               # 16: back to the body
+        rsl.PATTERN_OP_JUMP_IF_INACTIVE, warning, 33, 0,               # 19: while, exits past the loop
+        rsl.PATTERN_OP_COLOR, 0, 0, 255, rsl.PATTERN_OP_WAIT, 232, 3,  # 23
+        rsl.PATTERN_OP_JUMP, 19, 0,                                    # 30: back to the condition
+        rsl.PATTERN_OP_JUMP_IF_INACTIVE, ota, 43, 0,                   # 33: if, else branch at 43
+        rsl.PATTERN_OP_WAIT, 10, 0,                                    # 37
+        rsl.PATTERN_OP_JUMP, 46, 0,                                    # 40: skip the else branch
+        rsl.PATTERN_OP_WAIT, 20, 0,                                    # 43
+    ]
+    check(code == expected, f"bytecode {code}")
+
+
+def test_loops_must_wait():
+    check(rejects(rsl.pattern_block(0), [{"while": {"condition": "warning", "then": [color(1, 0, 0)]}}]),
+          "while body without a wait")
+    check(rejects(rsl.pattern_block(0), [{"repeat": {"count": 2, "then": [color(1, 0, 0), wait(0)]}}]),
+          "repeat body with only a zero wait")
+    check(rejects(rsl.pattern_block(0), [{"while": {"condition": "warning", "then": [
+        {"if": {"condition": "error", "then": [wait(10)], "else": []}}]}}]),
+        "while body that waits on one branch only")
+    check(not rejects(rsl.pattern_block(0), [{"while": {"condition": "warning", "then": [
+        {"repeat": {"count": 2, "then": [wait(10)]}}]}}]),
+        "while body waiting inside a repeat")
+
+
+def test_program_must_wait():
+    check(rejects(rsl.validate_pattern_waits, [color(1, 0, 0)]), "program without a wait")
+    check(rejects(rsl.validate_pattern_waits, [{"while": {"condition": "warning", "then": [wait(10)]}}]),
+          "program waiting only inside a while")
+    check(rejects(rsl.validate_pattern_waits, [{"if": {"condition": "warning", "then": [wait(10)], "else": []}}]),
+          "program waiting on one branch only")
+    check(not rejects(rsl.validate_pattern_waits, [{"if": {"condition": "warning", "then": [wait(10)],
+                                                           "else": [wait(5)]}}]),
+          "program waiting on both branches")
+
+
+test_compile()
+test_loops_must_wait()
+test_program_must_wait()
+if failures:
+    print(f"{failures} check(s) failed")
+sys.exit(1 if failures else 0)
@@ -0,0 +1,51 @@
+// Fixed-point pulse waveform against the sin() implementation it replaced
+
+#include "host.h"
+#include "rgb_status_led/render.h"
+#include <cmath>
+
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+/// The former float renderer: (sin(2*pi*t/period) + 1) / 2
+double reference_pulse(uint32_t now) {
+  double phase = static_cast<double>(now % PULSE_PERIOD) / PULSE_PERIOD;
+  return (std::sin(phase * 2.0 * M_PI) + 1.0) / 2.0;
+}
+
+void test_error_bound() {
+  // Table interpolation error stays well below one 8-bit PWM step (1/255)
+  double max_error = 0.0;
+  for (uint32_t now = 0; now < 2 * PULSE_PERIOD; now++) {
+    double error = std::fabs(pulse_level(now) / 65535.0 - reference_pulse(now));
+    if (error > max_error) {
+      max_error = error;
+    }
+  }
+  std::printf("pulse max error vs sin(): %.2e\n", max_error);
+  CHECK(max_error < 1e-4);
+}
+
+void test_waveform_shape() {
+  CHECK(pulse_level(0) == 32767);                      // Starts at the midpoint
+  CHECK(pulse_level(PULSE_PERIOD / 4) == 65535);       // Peak
+  CHECK(pulse_level(3 * PULSE_PERIOD / 4) == 0);       // Trough
+  CHECK(pulse_level(PULSE_PERIOD) == pulse_level(0));  // Periodic
+  CHECK(pulse_level(0xFFFFFFFFu) == pulse_level(0xFFFFFFFFu % PULSE_PERIOD));  // millis() wrap
+}
+
+void test_table_monotonic() {
+  for (uint8_t i = 0; i < PULSE_TABLE_STEPS; i++) {
+    CHECK(PULSE_TABLE.values[i] < PULSE_TABLE.values[i + 1]);
+  }
+}
+
+}  // namespace
+
+int main() {
+  test_error_bound();
+  test_waveform_shape();
+  test_table_monotonic();
+  return esphome::host::result();
+}
@@ -0,0 +1,167 @@
+// Status source registry: ranking, ties, anchors, user control and disabled sources
+
+#include "host.h"
+#include "esphome/core/application.h"
+#include "rgb_status_led/automation.h"
+#include "rgb_status_led/rgb_status_led.h"
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+struct Fixture {
+  output::FloatOutput red, green, blue;
+  RGBStatusLED led;
+
+  Fixture() {
+    host::reset();
+    this->led.set_red_output(&this->red);
+    this->led.set_green_output(&this->green);
+    this->led.set_blue_output(&this->blue);
+    this->led.set_brightness(1.0f);
+    this->led.setup();
+    this->led.loop();
+    host::run(&this->led, 10100);  // Past BOOT, OK is solid green
+  }
+
+  /// Solid source tagged by its red level, `tag` tenths; blue marks it as a source
+  StatusSource *add(const char *name, StatusState above, uint8_t priority, uint8_t tag, bool enabled = true) {
+    return this->led.register_source(name, above, priority,
+                                     EventConfig(enabled, {tag / 10.0f, 0.0f, 1.0f}, 1.0f, EffectType::NONE));
+  }
+
+  /// Tag of the displayed source, 0 for a built-in state
+  int shown() {
+    host::run(&this->led, 1);
+    if (this->blue.level < 0.99f) {
+      return 0;
+    }
+    return static_cast<int>(this->red.level * 10.0f + 0.5f);
+  }
+};
+
+void test_rank_order() {
+  Fixture f;
+  StatusSource *low = f.add("low", StatusState::API_CONNECTED, 0, 1);
+  StatusSource *high = f.add("high", StatusState::WARNING, 0, 2);
+  StatusSource *mid = f.add("mid", StatusState::API_CONNECTED, 5, 3);
+  CHECK(f.shown() == 0);
+
+  low->raise();
+  high->raise();
+  mid->raise();
+  CHECK(f.shown() == 2);  // Higher anchor beats higher priority
+  high->clear();
+  CHECK(f.shown() == 3);  // Same anchor, higher priority
+  mid->clear();
+  CHECK(f.shown() == 1);
+
+  // Registering moves the slots above the insertion point; raised sources keep their place
+  StatusSource *late = f.add("late", StatusState::API_CONNECTED, 3, 4);
+  CHECK(f.shown() == 1);
+  mid->raise();
+  CHECK(f.shown() == 3);
+  late->raise();
+  CHECK(f.shown() == 3);
+  mid->clear();
+  CHECK(f.shown() == 4);
+  late->clear();
+  CHECK(f.shown() == 1);
+  low->clear();
+  CHECK(f.shown() == 0);
+  CHECK(f.led.get_source("late") == late && f.led.get_source("missing") == nullptr);
+}
+
+void test_equal_rank() {
+  Fixture f;
+  StatusSource *first = f.add("first", StatusState::API_CONNECTED, 2, 1);
+  StatusSource *second = f.add("second", StatusState::API_CONNECTED, 2, 2);
+  second->raise();
+  first->raise();
+  CHECK(f.shown() == 1);  // The earlier registration wins
+
+  // Still true after a third source of the same rank is inserted
+  StatusSource *third = f.add("third", StatusState::API_CONNECTED, 2, 3);
+  third->raise();
+  CHECK(f.shown() == 1);
+  first->clear();
+  CHECK(f.shown() == 2);
+}
+
+void test_anchor() {
+  Fixture f;
+  StatusSource *below = f.add("below", StatusState::BOOT, 255, 1);
+  StatusSource *at = f.add("at", StatusState::WARNING, 0, 2);
+  App.set_app_state(STATUS_LED_WARNING);
+  host::run(&f.led, 200);
+
+  // A source above a lower state does not beat WARNING, whatever its priority
+  below->raise();
+  CHECK(f.shown() == 0);
+
+  // Anchored at WARNING it ranks directly above it
+  at->raise();
+  CHECK(f.shown() == 2);
+
+  // ERROR outranks both
+  App.set_app_state(STATUS_LED_ERROR);
+  host::run(&f.led, 200);
+  CHECK(f.shown() == 0);
+  App.set_app_state(0);
+  host::run(&f.led, 200);
+  CHECK(f.shown() == 2);
+}
+
+void test_user_control() {
+  Fixture f;
+  StatusSource *source = f.add("source", StatusState::OTA_ERROR, 255, 1);
+  f.led.set_priority_mode("user");
+  host::run(&f.led, 10);
+
+  // Sources never override user control, not even above the highest state
+  uint32_t writes = f.red.writes + f.green.writes + f.blue.writes;
+  source->raise();
+  host::run(&f.led, 100);
+  CHECK(f.red.writes + f.green.writes + f.blue.writes == writes);
+
+  f.led.set_priority_mode("status");
+  CHECK(f.shown() == 1);
+}
+
+void test_disabled_source() {
+  Fixture f;
+  StatusSource *shown = f.add("shown", StatusState::API_CONNECTED, 0, 1);
+  StatusSource *disabled = f.add("disabled", StatusState::WARNING, 0, 2, false);
+  shown->raise();
+  disabled->raise();
+  CHECK(disabled->is_active());
+  CHECK(f.shown() == 1);  // Like a disabled event, the next source down shows
+
+  // The bitmap rebuilt on registration keeps it out as well
+  f.add("other", StatusState::API_CONNECTED, 1, 3);
+  CHECK(f.shown() == 1);
+}
+
+void test_actions() {
+  Fixture f;
+  StatusSource *source = f.add("source", StatusState::API_CONNECTED, 0, 1);
+  SourceRaiseAction<> raise(source);
+  SourceClearAction<> clear(source);
+  raise.play();
+  CHECK(source->is_active() && f.shown() == 1);
+  clear.play();
+  CHECK(!source->is_active() && f.shown() == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_rank_order();
+  test_equal_rank();
+  test_anchor();
+  test_user_control();
+  test_disabled_source();
+  test_actions();
+  return host::result();
+}
@@ -0,0 +1,317 @@
+// State resolution and scheduling on the virtual clock
+
+#include "host.h"
+#include "esphome/core/application.h"
+#include "rgb_status_led/rgb_status_led.h"
+#include "rgb_status_led/render.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+struct Fixture {
+  output::FloatOutput red, green, blue;
+  RGBStatusLED led;
+
+  Fixture() {
+    host::reset();
+    this->led.set_red_output(&this->red);
+    this->led.set_green_output(&this->green);
+    this->led.set_blue_output(&this->blue);
+    this->led.set_brightness(1.0f);
+    this->led.setup();
+    this->led.loop();  // First loop only arms the state machine
+  }
+};
+
+void test_boot_then_ok() {
+  Fixture f;
+  host::run(&f.led, 100);
+  CHECK(f.red.level == 1.0f && f.green.level == 0.0f && f.blue.level == 0.0f);  // BOOT: red
+
+  host::run(&f.led, 10000);
+  CHECK_NEAR(f.red.level, 0.0, 1e-6);  // OK: green
+  CHECK_NEAR(f.green.level, 1.0, 1e-6);
+  CHECK_NEAR(f.blue.level, 0.1, 1.0 / 255);  // Packed to 8 bits
+}
+
+void test_app_error_blinks() {
+  Fixture f;
+  host::run(&f.led, 10100);
+  App.set_app_state(STATUS_LED_ERROR);
+
+  // ERROR blinks red at 250ms with 60% duty: count lit milliseconds over 10 periods
+  uint32_t lit = 0;
+  for (uint32_t ms = 0; ms < 2500; ms++) {
+    host::run(&f.led, 1);
+    lit += f.red.level > 0.5f ? 1 : 0;
+    CHECK(f.green.level == 0.0f);
+  }
+  CHECK_NEAR(lit, 1500, 2);
+
+  App.set_app_state(0);
+  host::run(&f.led, 10);
+  CHECK_NEAR(f.green.level, 1.0, 1e-6);
+}
+
+void test_blink_speed_rejects_out_of_range() {
+  Fixture f;
+  f.led.set_error_blink_speed(0);
+  f.led.set_error_blink_speed(70000);  // Would truncate to 4464ms in the 16-bit period
+  host::run(&f.led, 10100);
+  App.set_app_state(STATUS_LED_ERROR);
+
+  // Still the default 250ms at 60% duty
+  uint32_t lit = 0;
+  for (uint32_t ms = 0; ms < 2500; ms++) {
+    host::run(&f.led, 1);
+    lit += f.red.level > 0.5f ? 1 : 0;
+  }
+  CHECK_NEAR(lit, 1500, 2);
+  App.set_app_state(0);
+}
+
+void test_event_driven_sleeps() {
+  Fixture f;
+  f.led.set_event_driven(true);
+  host::run(&f.led, 10100);
+
+  // Solid OK: only the app state poll wakes the loop
+  uint32_t writes = f.red.writes + f.green.writes + f.blue.writes;
+  uint32_t loops = host::run(&f.led, 5000);
+  CHECK(loops <= 5000 / 100 + 1);
+  CHECK(f.red.writes + f.green.writes + f.blue.writes == writes);
+
+  // Setters wake it straight away
+  f.led.set_ota_error();
+  CHECK(f.led.is_loop_enabled());
+  host::run(&f.led, 1);
+  CHECK(f.red.level == 1.0f);
+}
+
+void test_composite_setter_renders_once() {
+  Fixture f;
+  host::run(&f.led, 10100);
+  f.led.set_ota_begin();
+  CHECK(f.blue.level == 1.0f && f.green.level == 0.0f);  // OTA_BEGIN: blue, rendered right away
+
+  // Ending OTA and raising OTA_ERROR in one call must not show green OK in between
+  uint32_t green_writes = f.green.writes;
+  f.led.set_ota_error();
+  CHECK(f.green.writes == green_writes);
+  CHECK(f.blue.level == 0.0f);
+}
+
+void test_event_disabled_in_table() {
+  // Another instance may have compiled ERROR in; this instance's table keeps it off
+  PackedEventConfig table[STATUS_STATE_COUNT];
+  for (uint8_t i = 0; i < STATUS_STATE_COUNT; i++) {
+    table[i] = DEFAULT_EVENT_TABLE[i];
+  }
+  table[static_cast<uint8_t>(StatusState::ERROR)].flags &= ~PackedEventConfig::FLAG_ENABLED;
+
+  Fixture f;
+  f.led.set_event_table(table);
+  host::run(&f.led, 10100);
+  App.set_app_state(STATUS_LED_ERROR);
+  for (uint32_t ms = 0; ms < 500; ms += 10) {
+    host::run(&f.led, 10);
+    CHECK_NEAR(f.green.level, 1.0, 1e-6);  // Still OK
+  }
+}
+
+#ifdef RGB_STATUS_LED_USE_CODE
+uint32_t count_flashes(Fixture &f, uint32_t ms) {
+  uint32_t flashes = 0;
+  bool lit = f.red.level > 0.5f;
+  for (uint32_t t = 0; t < ms; t++) {
+    host::run(&f.led, 1);
+    flashes += !lit && f.red.level > 0.5f ? 1 : 0;
+    lit = f.red.level > 0.5f;
+  }
+  return flashes;
+}
+
+void test_runtime_error_code() {
+  Fixture f;
+  f.led.set_error_config(EventConfig(true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::CODE));
+  host::run(&f.led, 10100);
+  App.set_app_state(STATUS_LED_ERROR);
+
+  // 125ms slots: the table's code 0 stays dark, code 4 repeats every 12 slots, code 1 every 6
+  CHECK(count_flashes(f, 3000) == 0);
+  f.led.set_error_code(4);
+  CHECK_NEAR(count_flashes(f, 3000), 8, 1);
+  f.led.set_error_code(1);
+  CHECK_NEAR(count_flashes(f, 3000), 4, 1);
+  App.set_app_state(0);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_LATENCY
+void test_polled_latency_counts_poll_gap() {
+  Fixture f;
+  f.led.set_event_driven(true);
+  host::run(&f.led, 10100);
+
+  // Raised 10ms after a poll, noticed at the next one 100ms after it: timed from the earlier poll
+  host::run(&f.led, 10);
+  App.set_app_state(STATUS_LED_ERROR);
+  host::run(&f.led, 200);
+  uint32_t p99 = f.led.get_latency_percentile(99);
+  CHECK(p99 >= 65536 && p99 < 131072);  // 100ms lands in the 65-131ms bucket
+  App.set_app_state(0);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_DITHER
+void test_dither_frames() {
+  Fixture f;
+  f.led.set_dither_bits(8);
+  f.led.set_event_driven(true);
+  host::run(&f.led, 10100);
+
+  // OK sits on 8-bit steps: nothing to dither, sleeps like without dithering
+  uint32_t writes = f.red.writes + f.green.writes + f.blue.writes;
+  CHECK(host::run(&f.led, 5000) <= 5000 / 100 + 1);
+  CHECK(f.red.writes + f.green.writes + f.blue.writes == writes);
+
+  // Half brightness falls between steps: one frame per 16ms, averaging to the exact level
+  f.led.set_brightness(0.5f);
+  host::run(&f.led, 100);
+  double sum = 0.0;
+  float low = 1.0f, high = 0.0f;
+  uint32_t loops = 0;
+  for (uint32_t ms = 0; ms < 1600; ms++) {
+    loops += host::run(&f.led, 1);
+    sum += f.green.level;
+    low = std::min(low, f.green.level);
+    high = std::max(high, f.green.level);
+  }
+  CHECK_NEAR(loops, 100, 2);
+  CHECK_NEAR(sum / 1600, 0.25, 0.5 / 255);  // Event brightness 1.0 takes the global one twice
+  CHECK_NEAR(high - low, 1.0 / 255, 1e-6);  // Flips between neighbouring steps only
+
+  // Without event-driven mode loop() runs every millisecond, frames still last 16ms
+  f.led.set_event_driven(false);
+  writes = f.green.writes;
+  host::run(&f.led, 1600);
+  CHECK(f.green.writes - writes <= 1600 / 16 + 1);
+
+  // Frames follow the time passed to update_at(), not the wall clock
+  writes = f.green.writes;
+  uint32_t start = static_cast<uint32_t>(host::now_us() / 1000);
+  sum = 0.0;
+  for (uint32_t ms = 0; ms < 1600; ms++) {
+    f.led.update_at(start + ms);
+    sum += f.green.level;
+  }
+  CHECK(f.green.writes != writes && f.green.writes - writes <= 1600 / 16 + 1);
+  CHECK_NEAR(sum / 1600, 0.25, 0.5 / 255);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_CORRECTION
+void test_correction_per_instance() {
+  // The correction define is build-wide; only the instance given a table is corrected
+  static uint16_t square[CORRECTION_TABLE_STEPS + 1];
+  for (uint32_t i = 0; i <= CORRECTION_TABLE_STEPS; i++) {
+    square[i] = i * i * 65535 / (CORRECTION_TABLE_STEPS * CORRECTION_TABLE_STEPS);
+  }
+  Fixture corrected;
+  corrected.led.set_correction_table(square);
+  output::FloatOutput red, green, blue;
+  RGBStatusLED plain;
+  plain.set_red_output(&red);
+  plain.set_green_output(&green);
+  plain.set_blue_output(&blue);
+  plain.set_brightness(1.0f);
+  plain.setup();
+  plain.loop();
+
+  for (uint32_t ms = 0; ms < 10100; ms += 10) {
+    host::advance(10);
+    corrected.led.loop();
+    plain.loop();
+  }
+  CHECK_NEAR(corrected.blue.level, 0.01, 1.0 / 255);
+  CHECK_NEAR(blue.level, 0.1, 1.0 / 255);
+}
+#endif
+
+#ifdef RGB_STATUS_LED_TRANSITION
+void test_transition_hands_over() {
+  Fixture f;
+  f.led.set_transition_length(200);
+  f.led.set_transition_max_fps(50);  // 20ms frames, the 10th hands over to the effect
+  f.led.set_warning_config(EventConfig(true, {1.0f, 0.0f, 0.0f}, 1.0f, EffectType::PULSE));
+  host::run(&f.led, 10100);
+
+  // Change state so that the handover lands near the pulse trough, far from the full color
+  while (host::now_us() / 1000 % PULSE_PERIOD != 1300) {
+    host::run(&f.led, 1);
+  }
+  App.set_app_state(STATUS_LED_WARNING);
+
+  // Green fades out from OK; each of its writes is one frame
+  std::vector<uint32_t> frames;
+  float last_fade_red = -1.0f, handover_red = -1.0f;
+  uint32_t writes = f.green.writes;
+  for (uint32_t ms = 0; ms < 400; ms++) {
+    float red = f.red.level;
+    host::run(&f.led, 1);
+    if (f.green.writes == writes) {
+      continue;
+    }
+    writes = f.green.writes;
+    frames.push_back(static_cast<uint32_t>(host::now_us() / 1000));
+    if (f.green.level == 0.0f) {
+      last_fade_red = red;
+      handover_red = f.red.level;
+    }
+  }
+  CHECK(frames.size() == 10);
+  bool limited = true;
+  for (size_t i = 1; i < frames.size(); i++) {
+    limited &= frames[i] - frames[i - 1] >= 20;
+  }
+  CHECK(limited);
+  CHECK(frames.back() - frames.front() == 180);
+
+  // The fade ends where the pulse takes over instead of jumping from the full color
+  CHECK(handover_red >= 0.0f && handover_red < 0.1f);
+  CHECK(std::fabs(handover_red - last_fade_red) < 0.02f);
+  App.set_app_state(0);
+}
+#endif
+
+}  // namespace
+
+int main() {
+  test_boot_then_ok();
+  test_app_error_blinks();
+  test_blink_speed_rejects_out_of_range();
+  test_event_driven_sleeps();
+  test_composite_setter_renders_once();
+  test_event_disabled_in_table();
+#ifdef RGB_STATUS_LED_USE_CODE
+  test_runtime_error_code();
+#endif
+#ifdef RGB_STATUS_LED_LATENCY
+  test_polled_latency_counts_poll_gap();
+#endif
+#ifdef RGB_STATUS_LED_DITHER
+  test_dither_frames();
+#endif
+#ifdef RGB_STATUS_LED_CORRECTION
+  test_correction_per_instance();
+#endif
+#ifdef RGB_STATUS_LED_TRANSITION
+  test_transition_hands_over();
+#endif
+  return host::result();
+}
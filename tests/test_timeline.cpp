@@ -0,0 +1,127 @@
+// Keyframe timeline playback: cursor, cycle skip and interpolation
+
+#include "host.h"
+#include "esphome/core/application.h"
+#include "rgb_status_led/rgb_status_led.h"
+
+using namespace esphome;
+using namespace esphome::rgb_status_led;
+
+namespace {
+
+// red 100ms, green 200ms, blue 300ms
+const Keyframe STEPS[3] = {{100, 255, 0, 0, Keyframe::STEP},
+                           {200, 0, 255, 0, Keyframe::STEP},
+                           {300, 0, 0, 255, Keyframe::STEP}};
+// A 40s ramp from off to red, then 1s off
+const Keyframe RAMP[2] = {{40000, 255, 0, 0, Keyframe::LINEAR}, {1000, 0, 0, 0, Keyframe::STEP}};
+
+struct Fixture {
+  output::FloatOutput red, green, blue;
+  RGBStatusLED led;
+  Timeline timelines[STATUS_STATE_COUNT]{};
+
+  /// Shows `timeline` for WARNING; the clock is left on the first rendered frame
+  explicit Fixture(const Timeline &timeline) {
+    host::reset();
+    this->timelines[static_cast<uint8_t>(StatusState::WARNING)] = timeline;
+    this->led.set_red_output(&this->red);
+    this->led.set_green_output(&this->green);
+    this->led.set_blue_output(&this->blue);
+    this->led.set_brightness(1.0f);
+    this->led.set_timeline_table(this->timelines);
+    this->led.set_warning_config(EventConfig(true, {1.0f, 1.0f, 1.0f}, 1.0f, EffectType::TIMELINE));
+    this->led.setup();
+    this->led.loop();
+    host::run(&this->led, 10100);  // Past BOOT, OK is solid green
+
+    App.set_app_state(STATUS_LED_WARNING);
+    for (uint32_t ms = 0; ms < 1000 && this->green.level > 0.5f; ms++) {
+      host::run(&this->led, 1);
+    }
+  }
+  ~Fixture() { App.set_app_state(0); }
+
+  /// Channel index lit by the STEPS timeline, -1 for none or several
+  int lit() const {
+    int lit = -1;
+    const float levels[3] = {this->red.level, this->green.level, this->blue.level};
+    for (int i = 0; i < 3; i++) {
+      if (levels[i] > 0.5f) {
+        lit = lit == -1 ? i : -2;
+      }
+    }
+    return lit < 0 ? -1 : lit;
+  }
+};
+
+int expected_step(uint32_t elapsed) {
+  uint32_t offset = elapsed % 600;
+  return offset < 100 ? 0 : offset < 300 ? 1 : 2;
+}
+
+void test_cursor_follows_keyframes() {
+  Fixture f({STEPS, 3, 600});
+  CHECK(f.lit() == 0);
+
+  // Three full cycles, one millisecond at a time
+  bool matched = true;
+  for (uint32_t elapsed = 1; elapsed < 1800; elapsed++) {
+    host::run(&f.led, 1);
+    matched &= f.lit() == expected_step(elapsed);
+  }
+  CHECK(matched);
+}
+
+void test_cycle_skip() {
+  Fixture f({STEPS, 3, 600});
+
+  // A long gap without loop() calls lands on the same keyframe as continuous playback
+  const uint32_t gaps[] = {600 * 100 + 249, 600 * 7 + 49, 600 * 50 + 599, 12345};
+  uint32_t elapsed = 0;
+  for (uint32_t gap : gaps) {
+    host::advance(gap);
+    host::run(&f.led, 1);
+    elapsed += gap + 1;
+    CHECK(f.lit() == expected_step(elapsed));
+  }
+}
+
+void test_linear_reaches_target() {
+  Fixture f({RAMP, 2, 41000});
+  CHECK_NEAR(f.red.level, 0.0, 1.0 / 255);
+
+  // Linear over the whole 40s, the last frame is within one step of the target
+  host::run(&f.led, 10000);
+  CHECK_NEAR(f.red.level, 0.25, 1.0 / 255);
+  host::run(&f.led, 10000);
+  CHECK_NEAR(f.red.level, 0.5, 1.0 / 255);
+  host::run(&f.led, 19999);
+  CHECK_NEAR(f.red.level, 1.0, 1.0 / 255);
+  host::run(&f.led, 1);
+  CHECK(f.red.level == 0.0f);  // Next keyframe
+}
+
+void test_brightness_keeps_position() {
+  Fixture f({RAMP, 2, 41000});
+  host::run(&f.led, 20000);
+  CHECK_NEAR(f.red.level, 0.5, 1.0 / 255);
+
+  // Rebuilding the plan for a new brightness scales the output but does not restart the ramp
+  f.led.set_brightness(0.5f);
+  host::run(&f.led, 1);
+  float half = f.red.level;
+  CHECK(half > 0.05f);
+  host::run(&f.led, 10000);
+  CHECK_NEAR(f.red.level, half * 1.5, 2.0 / 255);
+}
+
+}  // namespace
+
+int main() {
+  test_cursor_follows_keyframes();
+  test_cycle_skip();
+  test_linear_reaches_target();
+  test_brightness_keeps_position();
+  return host::result();
+}